@@ -0,0 +1,265 @@
+#ifndef __TMM_BATCH_H__
+#define __TMM_BATCH_H__
+
+/**
+ * \file batch.h
+ * \brief SIMD batch kernel of Bragg gratings
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+namespace tmm
+{
+	/**
+	 * \brief Lanes of the design-major batch kernel
+	 * 
+	 * Eight doubles fill an AVX-512 register, or two AVX2 registers.
+	 */
+	constexpr size_t batch_lanes = 8;
+
+	/**
+	 * \brief Design and wavelength points packed one per SIMD lane
+	 * 
+	 * Arrays are laid out structure-of-arrays so that every step of the kernel is a 
+	 * fixed-length loop over lanes that the compiler vectorizes. Lanes may hold 
+	 * different designs at one wavelength, one design at different wavelengths, or any mix.
+	 */
+	template<size_t W = batch_lanes>
+	struct design_batch
+	{
+		alignas(64) std::array<double, W> wavelength{}; ///< wavelengths
+		alignas(64) std::array<double, W> period{}; ///< grating periods
+		alignas(64) std::array<double, W> duty_cycle{}; ///< duty cycles
+		alignas(64) std::array<uint64_t, W> N{}; ///< number of periods, may differ per lane
+		alignas(64) std::array<double, W> n1{}; ///< effective index of the first section
+		alignas(64) std::array<double, W> n2{}; ///< effective index of the second section
+		alignas(64) std::array<double, W> loss{}; ///< loss, as in homogeneous_layer
+		size_t count = 0; ///< occupied lanes, the rest repeat lane 0
+	};
+
+	/**
+	 * \brief Results of a design batch
+	 */
+	template<size_t W = batch_lanes>
+	struct batch_result
+	{
+		alignas(64) std::array<double, W> R; ///< reflection
+		alignas(64) std::array<double, W> T; ///< transmission
+		alignas(64) std::array<double, W> r; ///< reflection phase
+		alignas(64) std::array<double, W> t; ///< transmission phase
+	};
+
+	namespace detail
+	{
+		/**
+		 * \brief 2x2 complex matrices of every lane, split into real and imaginary parts
+		 */
+		template<size_t W>
+		struct lane_matrix
+		{
+			alignas(64) std::array<double, W> re[2][2];
+			alignas(64) std::array<double, W> im[2][2];
+		};
+
+		/**
+		 * \brief C = A B in every lane
+		 */
+		template<size_t W>
+		inline void lane_multiply(const lane_matrix<W>& A, const lane_matrix<W>& B, lane_matrix<W>& C)
+		{
+			for (size_t i = 0; i < 2; ++i)
+				for (size_t j = 0; j < 2; ++j)
+					for (size_t l = 0; l < W; ++l)
+					{
+						C.re[i][j][l] = A.re[i][0][l] * B.re[0][j][l] - A.im[i][0][l] * B.im[0][j][l]
+							+ A.re[i][1][l] * B.re[1][j][l] - A.im[i][1][l] * B.im[1][j][l];
+						C.im[i][j][l] = A.re[i][0][l] * B.im[0][j][l] + A.im[i][0][l] * B.re[0][j][l]
+							+ A.re[i][1][l] * B.im[1][j][l] + A.im[i][1][l] * B.re[1][j][l];
+					}
+		}
+
+		/**
+		 * \brief Rescale every lane whose entries leave the representable range, as normalize
+		 * 
+		 * The largest real or imaginary part stands in for the largest magnitude, so that 
+		 * the test stays a select per lane.
+		 * 
+		 * \param A matrices, divided per lane by their largest part beyond 1e100 or 1e-100
+		 * \param log accumulated natural log of the scale removed from each lane
+		 */
+		template<size_t W>
+		inline void lane_normalize(lane_matrix<W>& A, std::array<double, W>& log)
+		{
+			alignas(64) std::array<double, W> m{};
+			for (size_t i = 0; i < 2; ++i)
+				for (size_t j = 0; j < 2; ++j)
+					for (size_t l = 0; l < W; ++l)
+						m[l] = std::max(m[l], std::max(std::abs(A.re[i][j][l]), std::abs(A.im[i][j][l])));
+			
+			// Rescaling is rare, the common case stays one pass of compares
+			bool any = false;
+			for (size_t l = 0; l < W; ++l)
+			{
+				const bool rescale = m[l] > 1e100 || (m[l] < 1e-100 && m[l] > 0);
+				m[l] = rescale ? m[l] : 1.0;
+				any |= rescale;
+			}
+			if (!any)
+				return;
+			
+			for (size_t l = 0; l < W; ++l)
+			{
+				log[l] += std::log(m[l]);
+				m[l] = 1.0 / m[l];
+			}
+			for (size_t i = 0; i < 2; ++i)
+				for (size_t j = 0; j < 2; ++j)
+					for (size_t l = 0; l < W; ++l)
+					{
+						A.re[i][j][l] *= m[l];
+						A.im[i][j][l] *= m[l];
+					}
+		}
+	}
+
+	/**
+	 * \brief Reflection and transmission of a batch of Bragg gratings
+	 * 
+	 * The period matrix of every lane is formed in closed form as in 
+	 * Bragg::transfer_matrix(Tp, p1, p2, n1, n2) and raised to its own N by binary 
+	 * exponentiation over the bits of the largest N, each lane taking the product only 
+	 * where its own bit is set, so that control flow is uniform across lanes. Every lane 
+	 * keeps its own log scale, so N deep inside a stopband stays finite.
+	 * 
+	 * \param batch the designs and wavelengths
+	 * \param phases compute r and t, NaN otherwise
+	 * \param out results per lane
+	 */
+	template<size_t W>
+	inline void 
+	batch_coefficients(const design_batch<W>& batch, bool phases, batch_result<W>& out)
+	{
+		using detail::lane_matrix;
+		
+		// Layer phases p = exp(i beta l) and q = 1/p, and the Fresnel coefficients
+		alignas(64) std::array<double, W> p1r, p1i, q1r, q1i, p2r, p2i, q2r, q2i, a, b;
+		for (size_t l = 0; l < W; ++l)
+		{
+			const double k0 = 2.0 * M_PI / batch.wavelength[l];
+			const double l1 = batch.period[l] * batch.duty_cycle[l];
+			const double l2 = batch.period[l] - l1;
+			const double g1 = 0.5 * batch.loss[l] * l1, g2 = 0.5 * batch.loss[l] * l2;
+			const double c1 = std::cos(k0 * batch.n1[l] * l1), s1 = std::sin(k0 * batch.n1[l] * l1);
+			const double c2 = std::cos(k0 * batch.n2[l] * l2), s2 = std::sin(k0 * batch.n2[l] * l2);
+			const double e1 = std::exp(g1), e2 = std::exp(g2);
+			
+			p1r[l] = e1 * c1; p1i[l] = e1 * s1; q1r[l] = c1 / e1; q1i[l] = -s1 / e1;
+			p2r[l] = e2 * c2; p2i[l] = e2 * s2; q2r[l] = c2 / e2; q2i[l] = -s2 / e2;
+			
+			const double root = 2.0 * std::sqrt(batch.n1[l] * batch.n2[l]);
+			a[l] = (batch.n1[l] + batch.n2[l]) / root;
+			b[l] = (batch.n1[l] - batch.n2[l]) / root;
+		}
+		
+		// Tp = [[p1 (a^2 p2 - b^2 q2), p1 ab (q2 - p2)], [q1 ab (p2 - q2), q1 (a^2 q2 - b^2 p2)]]
+		lane_matrix<W> base, result, work;
+		for (size_t l = 0; l < W; ++l)
+		{
+			const double aa = a[l] * a[l], bb = b[l] * b[l], ab = a[l] * b[l];
+			const double u_r = aa * p2r[l] - bb * q2r[l], u_i = aa * p2i[l] - bb * q2i[l];
+			const double v_r = ab * (q2r[l] - p2r[l]), v_i = ab * (q2i[l] - p2i[l]);
+			const double w_r = aa * q2r[l] - bb * p2r[l], w_i = aa * q2i[l] - bb * p2i[l];
+			
+			base.re[0][0][l] = p1r[l] * u_r - p1i[l] * u_i; base.im[0][0][l] = p1r[l] * u_i + p1i[l] * u_r;
+			base.re[0][1][l] = p1r[l] * v_r - p1i[l] * v_i; base.im[0][1][l] = p1r[l] * v_i + p1i[l] * v_r;
+			base.re[1][0][l] = -(q1r[l] * v_r - q1i[l] * v_i); base.im[1][0][l] = -(q1r[l] * v_i + q1i[l] * v_r);
+			base.re[1][1][l] = q1r[l] * w_r - q1i[l] * w_i; base.im[1][1][l] = q1r[l] * w_i + q1i[l] * w_r;
+			
+			result.re[0][0][l] = 1; result.im[0][0][l] = 0; result.re[0][1][l] = 0; result.im[0][1][l] = 0;
+			result.re[1][0][l] = 0; result.im[1][0][l] = 0; result.re[1][1][l] = 1; result.im[1][1][l] = 0;
+		}
+		
+		// Per-lane log scales keep the partial products representable deep in a stopband, 
+		// as scaled_power does for one matrix
+		alignas(64) std::array<double, W> result_log{}, base_log{};
+		
+		const uint64_t largest = *std::max_element(batch.N.begin(), batch.N.end());
+		for (uint64_t bit = 1; bit && bit <= largest; bit <<= 1)
+		{
+			// result = bit set ? result * base : result, per lane
+			detail::lane_multiply(result, base, work);
+			for (size_t i = 0; i < 2; ++i)
+				for (size_t j = 0; j < 2; ++j)
+					for (size_t l = 0; l < W; ++l)
+					{
+						const bool take = batch.N[l] & bit;
+						result.re[i][j][l] = take ? work.re[i][j][l] : result.re[i][j][l];
+						result.im[i][j][l] = take ? work.im[i][j][l] : result.im[i][j][l];
+					}
+			for (size_t l = 0; l < W; ++l)
+				result_log[l] += (batch.N[l] & bit) ? base_log[l] : 0.0;
+			detail::lane_normalize(result, result_log);
+			
+			if ((bit << 1) <= largest)
+			{
+				detail::lane_multiply(base, base, work);
+				base = work;
+				for (size_t l = 0; l < W; ++l)
+					base_log[l] *= 2;
+				detail::lane_normalize(base, base_log);
+			}
+		}
+		
+		// R = |M10 / M00|^2, T = exp(-2 log) / |M00|^2, with M00 and M10 of one scale
+		alignas(64) std::array<double, W> rho_r, rho_i;
+		for (size_t l = 0; l < W; ++l)
+		{
+			const double inverse = 1.0 / (result.re[0][0][l] * result.re[0][0][l] + result.im[0][0][l] * result.im[0][0][l]);
+			rho_r[l] = (result.re[1][0][l] * result.re[0][0][l] + result.im[1][0][l] * result.im[0][0][l]) * inverse;
+			rho_i[l] = (result.im[1][0][l] * result.re[0][0][l] - result.re[1][0][l] * result.im[0][0][l]) * inverse;
+			out.R[l] = rho_r[l] * rho_r[l] + rho_i[l] * rho_i[l];
+			out.T[l] = result_log[l] ? std::exp(-2.0 * result_log[l]) * inverse : inverse;
+		}
+		
+		if (!phases)
+		{
+			out.r.fill(NAN);
+			out.t.fill(NAN);
+			return;
+		}
+		
+		// r = arg(M10 / M00), t = arg(1 / M00) = arg(conj(M00))
+		for (size_t l = 0; l < W; ++l)
+		{
+			out.r[l] = std::atan2(rho_i[l], rho_r[l]);
+			out.t[l] = std::atan2(0.0 - result.im[0][0][l], result.re[0][0][l]); // +0, not -0, for real M00
+		}
+	}
+};//namespace tmm
+#endif //__TMM_BATCH_H__
@@ -32,6 +32,18 @@
 
 namespace tmm
 {
+	/**
+	 * \brief Sensitivities of an objective to the Bragg grating parameters
+	 */
+	struct bragg_gradient
+	{
+		double period = 0; ///< dJ/dperiod
+		double duty_cycle = 0; ///< dJ/dduty_cycle
+		double n1 = 0; ///< dJ/dn1
+		double n2 = 0; ///< dJ/dn2
+		double loss = 0; ///< dJ/dloss
+	};
+
 	/**
 	 * \brief Bragg Grating.
 	 * 
@@ -61,6 +73,17 @@ namespace tmm
 		 */
 		void transfer_matrix(std::complex<double>** Tp, double wavelength, double n1, double n2, double loss);	
 		
+		/**
+		 * \brief Compute transfer matrix for a single grating period from its layer phases
+		 * 
+		 * \param Tp transfer matrix for single period
+		 * \param p1 Propagation phase exp(i beta l) of the first section
+		 * \param p2 Propagation phase exp(i beta l) of the second section
+		 * \param n1 Effective index in first section
+		 * \param n2 Effective index in second section
+		 */
+		void transfer_matrix(std::complex<double>** Tp, std::complex<double> p1, std::complex<double> p2, double n1, double n2);
+		
 		/**
 		 * \brief Compute transfer matrix for N grating periods
 		 * 
@@ -79,10 +102,63 @@ namespace tmm
 		 * \param n1 Effective index in first section
 		 * \param n2 Effective index in second section
 		 * \param loss Loss in 1/m
+		 * \param phases compute the phases, NaN otherwise
 		 * \returns reflection and transmission coefficients and phases
 		 */
-		std::tuple<double, double, double, double> scattering_coefficients(double wavelength, double n1, double n2, double loss);
-		
+		std::tuple<double, double, double, double> scattering_coefficients(double wavelength, double n1, double n2, double loss, 
+			bool phases = true);
+
+		/**
+		 * \brief Compute reflection and transmission from the layer phases of a period
+		 * 
+		 * \param p1 Propagation phase exp(i beta l) of the first section
+		 * \param p2 Propagation phase exp(i beta l) of the second section
+		 * \param n1 Effective index in first section
+		 * \param n2 Effective index in second section
+		 * \param phases compute the phases, NaN otherwise
+		 * \returns reflection and transmission coefficients and phases
+		 */
+		std::tuple<double, double, double, double> scattering_coefficients(std::complex<double> p1, std::complex<double> p2, 
+			double n1, double n2, bool phases = true);
+
+		/**
+		 * \brief Compute the full scattering parameters at single wavelength
+		 * 
+		 * \param wavelength Wavelength in meters
+		 * \param n1 Effective index in first section
+		 * \param n2 Effective index in second section
+		 * \param loss Loss in 1/m
+		 * \returns S11, S21, S12 and S22 from one transfer matrix
+		 */
+		sparameters scattering_parameters(double wavelength, double n1, double n2, double loss);
+
+		/**
+		 * \brief Reverse-mode pass through transfer_matrix
+		 * 
+		 * \param Tp_bar Adjoint of the single period transfer matrix
+		 * \param wavelength Wavelength in meters
+		 * \param n1 Effective index in first section
+		 * \param n2 Effective index in second section
+		 * \param loss Loss in 1/m
+		 * \param grad Accumulated parameter sensitivities
+		 */
+		void transfer_matrix_adjoint(std::complex<double>** Tp_bar, double wavelength, double n1, double n2, double loss, bragg_gradient& grad);
+
+		/**
+		 * \brief Reverse-mode pass through scattering_matrix
+		 * 
+		 * \param T_bar Adjoint of the N period transfer matrix
+		 * \param wavelength Wavelength in meters
+		 * \param n1 Effective index in first section
+		 * \param n2 Effective index in second section
+		 * \param loss Loss in 1/m
+		 * \param grad Accumulated parameter sensitivities
+		 */
+		void scattering_matrix_adjoint(std::complex<double>** T_bar, double wavelength, double n1, double n2, double loss, bragg_gradient& grad);
+
+		double period() const { return _period; } ///< The period of the grating
+		double duty_cycle() const { return _duty_cycle; } ///< The dutycycle of the grating
+		double N() const { return _N; } ///< The number of periods
 	};
 }//namespace tmm
 #endif //__BRAGG_H__
\ No newline at end of file
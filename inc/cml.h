@@ -57,6 +57,20 @@ namespace tmm
 			
 			return y;
 		}
+
+		/**
+		 * \brief first derivative of the expansion at x
+		 */
+		double derivative(const double x) const
+		{
+			double dx = x - x0;
+			double y = 0.0;
+			
+			for (size_t i = 1; i < coeffs.size(); ++i)
+				y = O{}(y, i * coeffs[i] * std::pow(dx, i - 1));
+			
+			return y;
+		}
 	};	
 
 	/**
@@ -110,6 +124,15 @@ namespace tmm
 			
 			return prop;
 		}
+
+		/**
+		 * \brief sensitivity of the material property to width
+		 * \param w specify width
+		 */
+		double width_derivative(double w=0.0) const
+		{
+			return width_model ? width_model->derivative(w) : 0.0;
+		}
 	};
 };//namespace tmm
 #endif //__TMM_CML_H__
\ No newline at end of file
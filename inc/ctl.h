@@ -31,7 +31,14 @@
 
 #include <vector>
 #include <optional>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
 #include <cml.h>
+#include <spec.h>
+#include <variation.h>
+#include <disordered.h>
 
 namespace tmm
 {
@@ -41,6 +48,115 @@ namespace tmm
 	enum device_t: uint8_t
 	{
 		BRAGG,
+		DISORDERED,
+		PROFILE,
+	};
+
+	/**
+	 * \brief Analysis performed by TMM
+	 */
+	enum task_t: uint8_t
+	{
+		SWEEP, ///< evaluate every combination of the sweep-able parameters
+		OPTIMIZE, ///< inverse design against a spectral mask
+		FIT, ///< parameter extraction from a measured spectrum
+		FIT_BATCH, ///< parameter extraction from many measured spectra
+		MONTECARLO, ///< yield analysis under process variation
+		UQ, ///< polynomial chaos uncertainty quantification
+		SEARCH, ///< coarse-to-fine search for designs meeting a spectral mask
+		PARETO, ///< multi-objective front of a sweep
+		FIELD, ///< field distribution along the grating
+		DFB, ///< threshold and lasing modes of DFB lasers
+		KERR, ///< bistability of Kerr-nonlinear gratings
+		PULSE, ///< time-domain pulse response
+		VECTFIT, ///< pole-residue models of device responses
+	};
+
+	/**
+	 * \brief Design points evaluated by a sweep
+	 */
+	enum sampling_t: uint8_t
+	{
+		CARTESIAN, ///< every combination of the axes
+		SOBOL, ///< scrambled Sobol sequence within the axis bounds
+		LHS, ///< Latin hypercube within the axis bounds
+	};
+
+	/**
+	 * \brief Scattering parameter columns of sweeps
+	 */
+	enum sparameter_format_t: uint8_t
+	{
+		SP_NONE, ///< R, T and phases only
+		SP_POLAR, ///< magnitude and phase of S11, S21, S12, S22
+		SP_COMPLEX, ///< real and imaginary parts of S11, S21, S12, S22
+	};
+
+	/**
+	 * \brief Spectral window of time-domain transforms
+	 */
+	enum window_t: uint8_t
+	{
+		WINDOW_NONE, ///< rectangular
+		WINDOW_HANN, ///< raised cosine over the whole band
+		WINDOW_TUKEY, ///< raised cosine tapers over the band edges
+	};
+
+	/**
+	 * \brief Output columns of sweeps, combined as bit flags
+	 */
+	enum column_t: uint16_t
+	{
+		COL_N1 = 1 << 0, ///< n1 echo
+		COL_N2 = 1 << 1, ///< n2 echo
+		COL_LOSS = 1 << 2, ///< loss echo
+		COL_R = 1 << 3, ///< reflection
+		COL_T = 1 << 4, ///< transmission
+		COL_PHASE_R = 1 << 5, ///< reflection phase
+		COL_PHASE_T = 1 << 6, ///< transmission phase
+		COL_GROUP_DELAY = 1 << 7, ///< group delay, with --dl
+		COL_ALL = 0xff
+	};
+
+	/**
+	 * \brief Output writer of sweeps
+	 */
+	enum writer_t: uint8_t
+	{
+		WRITER_WRITE, ///< blocking write(2) calls
+		WRITER_URING, ///< asynchronous io_uring writes of a buffer pool
+	};
+
+	/**
+	 * \brief Line shape of the source or detector averaged over by sweeps
+	 */
+	enum lineshape_t: uint8_t
+	{
+		LINE_GAUSSIAN, ///< Gaussian line
+		LINE_LORENTZIAN, ///< Lorentzian line, cut at 10 FWHM
+		LINE_SINC2, ///< sinc^2 slit function of a spectrometer
+	};
+
+	/**
+	 * \brief Optimization algorithm
+	 */
+	enum optimizer_t: uint8_t
+	{
+		LBFGS, ///< adjoint gradient local search
+		DE, ///< differential evolution global search
+	};
+
+	/**
+	 * \brief Model parameters extracted from measured spectra
+	 */
+	enum fit_parameter_t: uint8_t
+	{
+		FIT_PERIOD, ///< grating period
+		FIT_N1, ///< offset of n1
+		FIT_N2, ///< offset of n2
+		FIT_WIDTH, ///< bias of both widths
+		FIT_LOSS, ///< offset of the loss
+		FIT_SIZE
 	};
 
 	/**
@@ -63,9 +179,61 @@ namespace tmm
 		
 		//Device type
 		device_t device = BRAGG; ///< Device type
+		disorder roughness; ///< Per-period disorder of disordered gratings
+		size_t realizations = 1; ///< Disorder realizations averaged per design
+		std::string profile; ///< Layer file of profile devices
 
 		//Analysis
+		task_t task = SWEEP; ///< Analysis to perform
+		sampling_t sampling = CARTESIAN; ///< Design points of sweeps
 		double dl; ///< Wavelength window for calculating group delay
+		size_t decimate = 1; ///< Periods between written boundaries of field profiles
+		sparameter_format_t sparameters = SP_NONE; ///< Scattering parameter columns of sweeps
+		double linewidth = 0; ///< FWHM of the line averaged over by sweeps (um), 0 disables
+		lineshape_t lineshape = LINE_GAUSSIAN; ///< Line shape averaged over by sweeps
+		uint16_t columns = COL_ALL; ///< Output columns of sweeps, column_t flags
+		bool explain = false; ///< Print the evaluation plan of sweeps instead of running them
+		std::vector<double> gain; ///< Modal gain window of lasing mode searches, [min,] max
+		double kerr = 0; ///< Nonlinear index coefficient, n = n0 + kerr * I
+		std::vector<double> power; ///< Output power range of nonlinear continuations, [min,] max
+		size_t steps = 200; ///< Continuation steps across the output power range
+		double pulse_width = 0; ///< Intensity FWHM of input pulses (ps)
+		double carrier = 0; ///< Carrier wavelength of input pulses (um), 0 selects the window centre
+		size_t fft_size = 4096; ///< Frequency samples of time-domain transforms
+		size_t pad = 1; ///< Zero-padding factor of time-domain transforms
+		window_t window = WINDOW_NONE; ///< Spectral window of time-domain transforms
+		size_t poles = 20; ///< Poles of fitted rational models
+
+		//Optimization
+		spec target; ///< Spectral mask defining the optimization objective
+		size_t sections = 1; ///< Number of independently optimized grating sections
+		size_t iterations = 100; ///< Optimizer iteration or generation limit
+		optimizer_t optimizer = LBFGS; ///< Optimization algorithm
+		size_t population = 0; ///< Population size of global optimizers, 0 selects automatically
+		unsigned seed = 1; ///< Random seed
+		std::string checkpoint; ///< Checkpoint file of global optimizers
+		size_t grid = 5; ///< Coarse grid points per axis of hierarchical searches
+		size_t depth = 4; ///< Refinement levels of hierarchical searches
+
+		//Fitting
+		std::string measured; ///< Measured spectrum file or directory
+		bool measured_reflection = false; ///< Measured spectrum is R rather than T
+		std::vector<fit_parameter_t> fit_parameters = {FIT_PERIOD, FIT_N1, FIT_N2, FIT_LOSS}; ///< Parameters to extract
+
+		//Uncertainty
+		std::vector<variation> variations; ///< Process variations of the nominal design
+		size_t samples = 0; ///< Number of random samples or sampled designs
+		std::vector<double> quantiles = {0.05, 0.5, 0.95}; ///< Reported quantiles
+		size_t order = 2; ///< Total degree of polynomial chaos expansions
+		size_t level = 2; ///< Level of the sparse quadrature grid
+
+		//Execution
+		size_t threads = 0; ///< Worker threads, 0 selects the hardware concurrency
+		std::string output; ///< Output file, standard output when empty
+		writer_t writer = WRITER_WRITE; ///< Output writer of sweeps
+		bool direct = false; ///< Open the output file with O_DIRECT
+		std::string shm_output; ///< Shared memory ring of sweep records, replaces the text output
+		bool shm_replace = false; ///< Replace an existing shared memory ring of the same name
 	};
 
 	/**
@@ -0,0 +1,77 @@
+#ifndef __TMM_DFB_H__
+#define __TMM_DFB_H__
+
+/**
+ * \file dfb.h
+ * \brief DFB laser threshold analysis
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <array>
+#include <vector>
+#include <ctl.h>
+#include <sampling.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Lasing mode of a DFB laser
+	 */
+	struct lasing_mode
+	{
+		double wavelength; ///< Lasing wavelength
+		double gain; ///< Threshold modal gain, in the units of the loss
+	};
+
+	/**
+	 * \brief Lasing modes of a design inside a (wavelength, gain) window
+	 * 
+	 * Lasing modes are the zeros of M00 of the total transfer matrix with the loss reduced 
+	 * by the gain. The window is split into rectangles and only rectangles around which 
+	 * M00 winds about the origin are refined, the argument principle counting the zeros 
+	 * inside; each isolated zero is then polished by Newton's method.
+	 * 
+	 * \param ctx control structure, for the material models
+	 * \param d the design
+	 * \param wavelength window [min, max] of wavelengths
+	 * \param gain window [min, max] of gains
+	 * \returns the modes in order of increasing gain
+	 */
+	std::vector<lasing_mode> lasing_modes(const ctl& ctx, const design& d, 
+		std::array<double, 2> wavelength, std::array<double, 2> gain);
+
+	/**
+	 * \brief Threshold analysis of DFB lasers
+	 * 
+	 * Writes, for every design of the sweep, the number of modes in the window of 
+	 * ctx.wavelengths and ctx.gain, the threshold gain and lasing wavelength of the lowest 
+	 * threshold mode and the gain margin to the next mode.
+	 * 
+	 * \param ctx control structure
+	 * \returns 0 on success
+	 */
+	int dfb(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_DFB_H__
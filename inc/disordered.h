@@ -0,0 +1,109 @@
+#ifndef __DISORDERED_H__
+#define __DISORDERED_H__
+
+/**
+ * \file disordered.h
+ * \brief Bragg grating with fabrication disorder
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <tmm.h>
+#include <cml.h>
+#include <vector>
+
+namespace tmm
+{
+	/**
+	 * \brief Statistics of period-to-period fabrication disorder
+	 * 
+	 * Perturbations are stationary Gaussian sequences along the grating with an
+	 * exponential autocorrelation exp(-|z|/correlation_length), generated as an AR(1) process.
+	 */
+	struct disorder
+	{
+		double width = 0; ///< standard deviation of the width of each region
+		double duty_cycle = 0; ///< standard deviation of the dutycycle
+		double correlation_length = 0; ///< correlation length, 0 for uncorrelated periods
+	};
+
+	/**
+	 * \brief Bragg grating with random per-period disorder.
+	 * 
+	 * Each period carries its own dutycycle and width offsets, so the N period matrices
+	 * differ and are reduced by an ordered multithreaded product instead of matrix_power.
+	 */
+	class Disordered : protected TMM
+	{
+		double _period; ///< The period of the grating
+		std::vector<double> _duty_cycle; ///< The dutycycle of each period
+		std::vector<double> _dw1; ///< Width offset of the high index region of each period
+		std::vector<double> _dw2; ///< Width offset of the low index region of each period
+
+		/**
+		 * \brief Ordered product of the period matrices, normalized
+		 * \returns natural log of the scale removed from T
+		 */
+		double product(std::complex<double>** T, double wavelength, const cml& n1, const cml& n2, 
+			double w1, double w2, double loss, size_t idx, size_t threads);
+	public:
+
+		/**
+		 * \brief Draw one realization of a disordered grating
+		 * 
+		 * \param period The period of the grating
+		 * \param duty_cycle The nominal dutycycle
+		 * \param N The number of periods
+		 * \param stats Disorder statistics
+		 * \param seed Random seed
+		 * \param realization Index of the realization, realizations are independent
+		 */
+		Disordered(double period, double duty_cycle, double N, const disorder& stats, uint64_t seed, size_t realization);
+
+		/**
+		 * \brief Compute transfer matrix for the N disordered periods
+		 * 
+		 * \param T Output 2x2 transfer matrix
+		 * \param wavelength Wavelength in meters
+		 * \param n1 High index material, evaluated at the perturbed width
+		 * \param n2 Low index material, evaluated at the perturbed width
+		 * \param w1 Nominal width of the high index region
+		 * \param w2 Nominal width of the low index region
+		 * \param loss Loss in 1/m
+		 * \param idx Index of the wavelength for sampled materials
+		 * \param threads Worker threads for the product, 0 for all cores
+		 */
+		void scattering_matrix(std::complex<double>** T, double wavelength, const cml& n1, const cml& n2, 
+			double w1, double w2, double loss, size_t idx = 0, size_t threads = 0);
+
+		/**
+		 * \brief Compute reflection and transmission at single wavelength
+		 * 
+		 * \returns reflection and transmission coefficients and phases
+		 */
+		std::tuple<double, double, double, double> scattering_coefficients(double wavelength, const cml& n1, const cml& n2, 
+			double w1, double w2, double loss, size_t idx = 0, size_t threads = 0);
+	};
+}//namespace tmm
+#endif //__DISORDERED_H__
@@ -0,0 +1,102 @@
+#ifndef __TMM_FFT_H__
+#define __TMM_FFT_H__
+
+/**
+ * \file fft.h
+ * \brief radix-2 fast Fourier transform
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <vector>
+#include <complex>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace tmm
+{
+	/**
+	 * \brief Smallest power of two not below n
+	 */
+	inline size_t next_pow2(size_t n)
+	{
+		size_t p = 1;
+		while (p < n)
+			p <<= 1;
+		return p;
+	}
+
+	/**
+	 * \brief In-place iterative radix-2 FFT
+	 * 
+	 * Computes X_k = sum_j x_j exp(-2 pi i jk/n), or exp(+2 pi i jk/n) when inverse, without 
+	 * the 1/n scale. Twiddles come from one table of the n-th roots of unity, so they are 
+	 * accurate to rounding for every stage.
+	 * 
+	 * \param x data, the size must be a power of two
+	 * \param inverse sign of the exponent
+	 */
+	inline void fft(std::vector<std::complex<double>>& x, bool inverse = false)
+	{
+		const size_t n = x.size();
+		if (n & (n - 1))
+			throw std::runtime_error("fft: size " + std::to_string(n) + " is not a power of two");
+		if (n < 2)
+			return;
+		
+		// Bit reversal permutation
+		for (size_t i = 1, j = 0; i < n; ++i)
+		{
+			size_t bit = n >> 1;
+			for (; j & bit; bit >>= 1)
+				j ^= bit;
+			j ^= bit;
+			if (i < j)
+				std::swap(x[i], x[j]);
+		}
+		
+		const double sign = inverse ? 1.0 : -1.0;
+		std::vector<std::complex<double>> twiddle(n / 2);
+		for (size_t k = 0; k < n / 2; ++k)
+			twiddle[k] = std::polar(1.0, sign * 2.0 * std::numbers::pi * k / n);
+		
+		for (size_t len = 2; len <= n; len <<= 1)
+		{
+			const size_t half = len >> 1, stride = n / len;
+			for (size_t i = 0; i < n; i += len)
+			{
+				for (size_t k = 0; k < half; ++k)
+				{
+					const std::complex<double> u = x[i + k];
+					const std::complex<double> v = x[i + k + half] * twiddle[k * stride];
+					x[i + k] = u + v;
+					x[i + k + half] = u - v;
+				}
+			}
+		}
+	}
+};//namespace tmm
+#endif //__TMM_FFT_H__
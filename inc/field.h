@@ -0,0 +1,53 @@
+#ifndef __TMM_FIELD_H__
+#define __TMM_FIELD_H__
+
+/**
+ * \file field.h
+ * \brief field distribution along gratings
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Field distribution along the nominal grating
+	 * 
+	 * The boundary state is propagated backward from the output port, where only the 
+	 * transmitted wave [t; 0] exists, through T_p^(N-k) to every period boundary k, which is 
+	 * stable inside the stopband. Boundaries are written every ctx.decimate periods from a 
+	 * single T_p^decimate step, in chunks that start from their own prefix power, so chunks 
+	 * run in parallel and only one wave of chunks is held in memory. Forward and backward 
+	 * powers and complex amplitudes are relative to the incident wave at the input port. 
+	 * The energy is |a|^2 + |b|^2 of these amplitudes, the period average of the standing 
+	 * wave |a + b|^2 at the boundary, not weighted by the index of the layer.
+	 * 
+	 * \param ctx control structure
+	 * \returns 0 on success
+	 */
+	int field(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_FIELD_H__
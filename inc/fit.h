@@ -0,0 +1,94 @@
+#ifndef __TMM_FIT_H__
+#define __TMM_FIT_H__
+
+/**
+ * \file fit.h
+ * \brief parameter extraction from measured spectra
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+#include <bragg.h>
+#include <array>
+
+namespace tmm
+{
+	/**
+	 * \brief Model parameters in fit_parameter_t order
+	 * 
+	 * The period is absolute, the remaining entries are offsets applied to 
+	 * n1, n2, both widths and the loss of the nominal model.
+	 */
+	using fit_vector = std::array<double, FIT_SIZE>;
+
+	/**
+	 * \brief Result of a spectrum fit
+	 */
+	struct fit_result
+	{
+		fit_vector value; ///< best fit parameters
+		fit_vector error; ///< standard error of each fitted parameter, 0 if held fixed
+		double rms; ///< root mean square residual
+		size_t iterations; ///< Levenberg-Marquardt iterations taken
+	};
+
+	/**
+	 * \brief Nominal parameters of the model in ctx
+	 */
+	fit_vector fit_initial(const ctl& ctx);
+
+	/**
+	 * \brief Fit the Bragg model to a measured spectrum
+	 * 
+	 * Levenberg-Marquardt on the parameters listed in ctx.fit_parameters. Jacobian rows
+	 * are the analytic sensitivities of R or T from one reverse-mode pass per wavelength.
+	 * 
+	 * \param ctx control structure
+	 * \param grid fitting wavelengths
+	 * \param measured measured R or T on the grid
+	 * \param initial starting parameters
+	 * \returns best fit parameters and their standard errors
+	 */
+	fit_result fit_spectrum(const ctl& ctx, const std::vector<double>& grid, 
+		const std::vector<double>& measured, const fit_vector& initial);
+
+	/**
+	 * \brief Fit ctx.measured and write the parameters with 95% confidence intervals to stdout
+	 * \returns 0 on success
+	 */
+	int fit(const ctl& ctx);
+
+	/**
+	 * \brief Fit every spectrum of a directory or concatenated file in parallel
+	 * 
+	 * Spectra are fitted independently on ctx.threads workers. Each fit starts from the 
+	 * solution of its predecessor in the file, and results stream to stdout one row per 
+	 * spectrum in input order.
+	 * 
+	 * \returns 0 on success
+	 */
+	int fit_batch(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_FIT_H__
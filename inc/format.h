@@ -0,0 +1,132 @@
+#ifndef __TMM_FORMAT_H__
+#define __TMM_FORMAT_H__
+
+/**
+ * \file format.h
+ * \brief text formatting of sweep rows
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+#include <tmm.h>
+#include <string>
+#include <charconv>
+#include <utility>
+#include <initializer_list>
+
+namespace tmm
+{
+	/**
+	 * \brief Optional sweep columns in output order
+	 */
+	inline constexpr std::pair<const char*, uint16_t> column_names[] = {
+		{"n1", COL_N1}, {"n2", COL_N2}, {"loss", COL_LOSS}, {"R", COL_R}, {"T", COL_T}, 
+		{"phase_r", COL_PHASE_R}, {"phase_t", COL_PHASE_T}, {"group_delay", COL_GROUP_DELAY}
+	};
+
+	/**
+	 * \brief Appends a value formatted as printf("%.6g")
+	 * 
+	 * std::to_chars in general format with precision 6 is specified to match printf, 
+	 * without its locale and stream overheads.
+	 */
+	inline void append(std::string& out, double value)
+	{
+		char buffer[32];
+		const auto end = std::to_chars(buffer, buffer + sizeof buffer, value, std::chars_format::general, 6).ptr;
+		out.append(buffer, end);
+	}
+
+	/**
+	 * \brief Appends a comma and a value formatted as printf("%.6g")
+	 */
+	inline void append_field(std::string& out, double value)
+	{
+		out += ',';
+		append(out, value);
+	}
+
+	/**
+	 * \brief Header of the selected optional sweep columns
+	 * 
+	 * \param out text appended to
+	 * \param columns column_t flags
+	 */
+	inline void format_column_header(std::string& out, uint16_t columns)
+	{
+		for (const auto& [name, flag] : column_names)
+			if (columns & flag)
+			{
+				out += ',';
+				out += name;
+			}
+	}
+
+	/**
+	 * \brief Selected optional sweep columns of one row, values in column_names order
+	 */
+	inline void format_columns(std::string& out, uint16_t columns, std::initializer_list<double> values)
+	{
+		size_t i = 0;
+		for (const double value : values)
+			if (columns & column_names[i++].second)
+				append_field(out, value);
+	}
+
+	/**
+	 * \brief Header of the scattering parameter columns
+	 */
+	inline void format_sparameter_header(std::string& out, sparameter_format_t format)
+	{
+		for (const std::string s : {"S11", "S21", "S12", "S22"})
+		{
+			if (format == SP_POLAR)
+				out += "," + s + "_mag," + s + "_phase";
+			if (format == SP_COMPLEX)
+				out += "," + s + "_re," + s + "_im";
+		}
+	}
+
+	/**
+	 * \brief Scattering parameter columns of one row
+	 */
+	inline void format_sparameters(std::string& out, sparameter_format_t format, const sparameters& S)
+	{
+		for (const auto& s : {S.S11, S.S21, S.S12, S.S22})
+		{
+			if (format == SP_POLAR)
+			{
+				append_field(out, std::abs(s));
+				append_field(out, std::arg(s));
+			}
+			if (format == SP_COMPLEX)
+			{
+				append_field(out, s.real());
+				append_field(out, s.imag());
+			}
+		}
+	}
+};//namespace tmm
+#endif //__TMM_FORMAT_H__
@@ -0,0 +1,51 @@
+#ifndef __TMM_KERR_H__
+#define __TMM_KERR_H__
+
+/**
+ * \file kerr.h
+ * \brief Kerr-nonlinear Bragg gratings
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Bistability map of a Kerr-nonlinear Bragg grating
+	 * 
+	 * The index of both layers is n + ctx.kerr * I, with I the power |a|^2 + |b|^2 of the 
+	 * counter-propagating waves averaged over each period. For every wavelength the output 
+	 * power is continued over ctx.power and the grating is integrated backward from the 
+	 * fixed output state, iterating the internal power profile to self-consistency. The 
+	 * input power is a single valued function of the output power, so the continuation 
+	 * traces every branch of the hysteresis loop, including the unstable one.
+	 * 
+	 * \param ctx control structure
+	 * \returns 0 on success
+	 */
+	int kerr(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_KERR_H__
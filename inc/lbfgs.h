@@ -0,0 +1,205 @@
+#ifndef __TMM_LBFGS_H__
+#define __TMM_LBFGS_H__
+
+/**
+ * \file lbfgs.h
+ * \brief limited memory BFGS optimizer
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <vector>
+#include <deque>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+
+namespace tmm
+{
+	/**
+	 * \brief Options for the L-BFGS optimizer
+	 */
+	struct lbfgs_options
+	{
+		size_t history = 8; ///< number of correction pairs kept
+		size_t max_iterations = 100; ///< iteration limit
+		double tolerance = 1e-9; ///< relative objective decrease and projected gradient tolerance
+	};
+
+	/**
+	 * \brief Box constrained limited memory BFGS
+	 * 
+	 * Minimizes f over lower <= x <= upper. The quasi-Newton direction from the 
+	 * two-loop recursion is restricted to the free variables and steps are projected 
+	 * back onto the box, with a backtracking Armijo line search.
+	 * 
+	 * \tparam F callable double(const std::vector<double>& x, std::vector<double>& g)
+	 * \param f objective returning f(x) and writing its gradient to g
+	 * \param x initial point, overwritten with the minimizer
+	 * \param lower lower bounds
+	 * \param upper upper bounds
+	 * \param opt optimizer options
+	 * \param progress optional callback invoked with (iteration, f(x)) 
+	 * \returns f at the minimizer
+	 */
+	template<typename F>
+	double lbfgs(F&& f, std::vector<double>& x, 
+		const std::vector<double>& lower, const std::vector<double>& upper, 
+		const lbfgs_options& opt = {},
+		std::function<void(size_t, double)> progress = nullptr)
+	{
+		const size_t n = x.size();
+		
+		auto project = [&](std::vector<double>& v)
+		{
+			for (size_t i = 0; i < n; ++i)
+				v[i] = std::clamp(v[i], lower[i], upper[i]);
+		};
+		
+		auto dot = [n](const std::vector<double>& a, const std::vector<double>& b)
+		{
+			double s = 0;
+			for (size_t i = 0; i < n; ++i)
+				s += a[i] * b[i];
+			return s;
+		};
+		
+		project(x);
+		
+		std::vector<double> g(n), g_new(n), x_new(n), d(n), pg(n), alpha;
+		std::deque<std::vector<double>> S, Y;
+		
+		double fx = f(x, g);
+		
+		for (size_t iter = 0; iter < opt.max_iterations; ++iter)
+		{
+			// Projected gradient: components pushing against an active bound are frozen
+			double pg_norm = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				bool frozen = (x[i] <= lower[i] && g[i] > 0) || (x[i] >= upper[i] && g[i] < 0);
+				pg[i] = frozen ? 0.0 : g[i];
+				pg_norm = std::max(pg_norm, std::abs(pg[i]));
+			}
+			
+			if (pg_norm < opt.tolerance)
+				break;
+			
+			// Two-loop recursion
+			d = pg;
+			alpha.assign(S.size(), 0.0);
+			for (size_t k = S.size(); k-- > 0;)
+			{
+				alpha[k] = dot(S[k], d) / dot(Y[k], S[k]);
+				for (size_t i = 0; i < n; ++i)
+					d[i] -= alpha[k] * Y[k][i];
+			}
+			
+			if (!S.empty())
+			{
+				double gamma = dot(S.back(), Y.back()) / dot(Y.back(), Y.back());
+				for (auto& v : d) 
+					v *= gamma;
+			}
+			
+			for (size_t k = 0; k < S.size(); ++k)
+			{
+				double b = dot(Y[k], d) / dot(Y[k], S[k]);
+				for (size_t i = 0; i < n; ++i)
+					d[i] += S[k][i] * (alpha[k] - b);
+			}
+			
+			for (size_t i = 0; i < n; ++i)
+				d[i] = (pg[i] == 0.0) ? 0.0 : -d[i];
+			
+			// Not a descent direction: restart from steepest descent
+			if (dot(d, pg) >= 0)
+			{
+				S.clear();
+				Y.clear();
+				for (size_t i = 0; i < n; ++i)
+					d[i] = -pg[i];
+			}
+			
+			double step = S.empty() ? std::min(1.0, 1.0 / pg_norm) : 1.0;
+			double f_new = fx;
+			bool accepted = false;
+			
+			for (size_t ls = 0; ls < 40; ++ls, step *= 0.5)
+			{
+				for (size_t i = 0; i < n; ++i)
+					x_new[i] = x[i] + step * d[i];
+				project(x_new);
+				
+				double decrease = 0;
+				for (size_t i = 0; i < n; ++i)
+					decrease += g[i] * (x_new[i] - x[i]);
+				
+				f_new = f(x_new, g_new);
+				
+				if (f_new <= fx + 1e-4 * decrease)
+				{
+					accepted = true;
+					break;
+				}
+			}
+			
+			if (!accepted)
+				break;
+			
+			std::vector<double> s(n), y(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				s[i] = x_new[i] - x[i];
+				y[i] = g_new[i] - g[i];
+			}
+			
+			if (dot(s, y) > 1e-16)
+			{
+				S.push_back(std::move(s));
+				Y.push_back(std::move(y));
+				if (S.size() > opt.history)
+				{
+					S.pop_front();
+					Y.pop_front();
+				}
+			}
+			
+			bool converged = std::abs(fx - f_new) <= opt.tolerance * std::max(1.0, std::abs(fx));
+			
+			x = x_new;
+			g = g_new;
+			fx = f_new;
+			
+			if (progress)
+				progress(iter, fx);
+			
+			if (converged)
+				break;
+		}
+		
+		return fx;
+	}
+};//namespace tmm
+#endif //__TMM_LBFGS_H__
@@ -0,0 +1,311 @@
+#ifndef __TMM_LINALG_H__
+#define __TMM_LINALG_H__
+
+/**
+ * \file linalg.h
+ * \brief small dense linear algebra
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <vector>
+#include <cmath>
+#include <utility>
+#include <stdexcept>
+#include <complex>
+#include <type_traits>
+
+namespace tmm
+{
+	/**
+	 * \brief Solve the dense linear system A x = b
+	 * 
+	 * Gaussian elimination with partial pivoting, A is stored row-major as n x n.
+	 * 
+	 * \param A system matrix, destroyed
+	 * \param b right hand side, overwritten with the solution
+	 * \param n system size
+	 */
+	template<typename T>
+	inline void solve(std::vector<T>& A, std::vector<T>& b, size_t n)
+	{
+		for (size_t k = 0; k < n; ++k)
+		{
+			size_t pivot = k;
+			for (size_t i = k + 1; i < n; ++i)
+				if (std::abs(A[i * n + k]) > std::abs(A[pivot * n + k]))
+					pivot = i;
+			
+			if (std::abs(A[pivot * n + k]) == 0.0)
+				throw std::runtime_error("singular system");
+			
+			if (pivot != k)
+			{
+				for (size_t j = 0; j < n; ++j)
+					std::swap(A[k * n + j], A[pivot * n + j]);
+				std::swap(b[k], b[pivot]);
+			}
+			
+			for (size_t i = k + 1; i < n; ++i)
+			{
+				T f = A[i * n + k] / A[k * n + k];
+				if (f == T(0))
+					continue;
+				for (size_t j = k; j < n; ++j)
+					A[i * n + j] -= f * A[k * n + j];
+				b[i] -= f * b[k];
+			}
+		}
+		
+		for (size_t k = n; k-- > 0;)
+		{
+			T s = b[k];
+			for (size_t j = k + 1; j < n; ++j)
+				s -= A[k * n + j] * b[j];
+			b[k] = s / A[k * n + k];
+		}
+	}
+
+	/**
+	 * \brief Inverse of the dense matrix A
+	 * 
+	 * \param A n x n row-major matrix
+	 * \param n matrix size
+	 * \returns A^-1 row-major
+	 */
+	template<typename T>
+	inline std::vector<T> invert(const std::vector<T>& A, size_t n)
+	{
+		std::vector<T> inverse(n * n);
+		
+		for (size_t j = 0; j < n; ++j)
+		{
+			std::vector<T> work = A, e(n, T(0));
+			e[j] = T(1);
+			solve(work, e, n);
+			for (size_t i = 0; i < n; ++i)
+				inverse[i * n + j] = e[i];
+		}
+		
+		return inverse;
+	}
+
+	/**
+	 * \brief Complex conjugate that leaves real types real
+	 */
+	template<typename T>
+	inline T conjugate(const T& x)
+	{
+		if constexpr (std::is_arithmetic_v<T>)
+			return x;
+		else
+			return std::conj(x);
+	}
+
+	/**
+	 * \brief Householder triangularization of a tall matrix
+	 * 
+	 * Reduces A to R = Q^H A in place, R upper triangular in the first n rows and zero
+	 * below. The same reflections are applied to b when given, producing Q^H b.
+	 * 
+	 * \param A m x n row-major matrix, m >= n, overwritten with R
+	 * \param m rows
+	 * \param n columns
+	 * \param b optional right hand side of m entries
+	 */
+	template<typename T>
+	inline void householder(std::vector<T>& A, size_t m, size_t n, std::vector<T>* b = nullptr)
+	{
+		std::vector<T> v(m);
+		
+		for (size_t k = 0; k < n && k < m; ++k)
+		{
+			double norm = 0;
+			for (size_t i = k; i < m; ++i)
+				norm += std::norm(A[i * n + k]);
+			norm = std::sqrt(norm);
+			if (norm == 0)
+				continue;
+			
+			// Reflect onto -phase(x0) |x| e_k, avoiding cancellation in v_k
+			const T x0 = A[k * n + k];
+			const T alpha = -(std::abs(x0) > 0 ? x0 / std::abs(x0) : T(1)) * norm;
+			
+			double vnorm = 0;
+			for (size_t i = k; i < m; ++i)
+			{
+				v[i] = A[i * n + k] - (i == k ? alpha : T(0));
+				vnorm += std::norm(v[i]);
+			}
+			if (vnorm == 0)
+				continue;
+			
+			auto reflect = [&](auto&& at)
+			{
+				T s = T(0);
+				for (size_t i = k; i < m; ++i)
+					s += conjugate(v[i]) * at(i);
+				s *= 2.0 / vnorm;
+				for (size_t i = k; i < m; ++i)
+					at(i) -= v[i] * s;
+			};
+			
+			for (size_t j = k; j < n; ++j)
+				reflect([&](size_t i) -> T& { return A[i * n + j]; });
+			if (b)
+				reflect([&](size_t i) -> T& { return (*b)[i]; });
+			
+			for (size_t i = k + 1; i < m; ++i)
+				A[i * n + k] = T(0);
+		}
+	}
+
+	/**
+	 * \brief Least squares solution of the overdetermined system A x = b
+	 * 
+	 * Householder QR, which unlike the normal equations keeps the conditioning of A.
+	 * 
+	 * \param A m x n row-major matrix, m >= n
+	 * \param b right hand side of m entries
+	 * \returns x of n entries
+	 */
+	template<typename T>
+	inline std::vector<T> least_squares(std::vector<T> A, std::vector<T> b, size_t m, size_t n)
+	{
+		householder(A, m, n, &b);
+		
+		std::vector<T> x(n);
+		for (size_t k = n; k-- > 0;)
+		{
+			if (std::abs(A[k * n + k]) == 0.0)
+				throw std::runtime_error("rank deficient least squares system");
+			T s = b[k];
+			for (size_t j = k + 1; j < n; ++j)
+				s -= A[k * n + j] * x[j];
+			x[k] = s / A[k * n + k];
+		}
+		return x;
+	}
+
+	/**
+	 * \brief Eigen decomposition of a symmetric tridiagonal matrix
+	 * 
+	 * Implicit QL with Wilkinson shifts. On return d holds the eigenvalues in 
+	 * ascending order and z the first component of each normalized eigenvector,
+	 * as needed by the Golub-Welsch quadrature construction.
+	 * 
+	 * \param d diagonal, overwritten with the eigenvalues
+	 * \param e sub-diagonal in e[1..n-1], destroyed
+	 * \param z output first eigenvector components
+	 */
+	inline void 
+	tridiagonal_eigen(std::vector<double>& d, std::vector<double>& e, std::vector<double>& z)
+	{
+		const size_t n = d.size();
+		
+		// Full eigenvectors are accumulated only through their first row
+		z.assign(n, 0.0);
+		z[0] = 1.0;
+		
+		for (size_t i = 1; i < n; ++i)
+			e[i - 1] = e[i];
+		if (n)
+			e[n - 1] = 0.0;
+		
+		for (size_t l = 0; l < n; ++l)
+		{
+			for (size_t iter = 0; ; ++iter)
+			{
+				size_t m = l;
+				for (; m + 1 < n; ++m)
+				{
+					double dd = std::abs(d[m]) + std::abs(d[m + 1]);
+					if (std::abs(e[m]) <= 1e-15 * dd)
+						break;
+				}
+				
+				if (m == l)
+					break;
+				
+				if (iter == 60)
+					throw std::runtime_error("tridiagonal eigenproblem did not converge");
+				
+				double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+				double r = std::hypot(g, 1.0);
+				g = d[m] - d[l] + e[l] / (g + (g >= 0 ? r : -r));
+				
+				double s = 1.0, c = 1.0, p = 0.0;
+				size_t i = m;
+				bool underflow = false;
+				
+				while (i-- > l)
+				{
+					double f = s * e[i];
+					double b = c * e[i];
+					r = std::hypot(f, g);
+					e[i + 1] = r;
+					
+					if (r == 0.0)
+					{
+						d[i + 1] -= p;
+						e[m] = 0.0;
+						underflow = true;
+						break;
+					}
+					
+					s = f / r;
+					c = g / r;
+					g = d[i + 1] - p;
+					r = (d[i] - g) * s + 2.0 * c * b;
+					p = s * r;
+					d[i + 1] = g + p;
+					g = c * r - b;
+					
+					f = z[i + 1];
+					z[i + 1] = s * z[i] + c * f;
+					z[i] = c * z[i] - s * f;
+				}
+				
+				if (underflow)
+					continue;
+				
+				d[l] -= p;
+				e[l] = g;
+				e[m] = 0.0;
+			}
+		}
+		
+		// Ascending order
+		for (size_t i = 0; i + 1 < n; ++i)
+		{
+			size_t k = i;
+			for (size_t j = i + 1; j < n; ++j)
+				if (d[j] < d[k])
+					k = j;
+			std::swap(d[i], d[k]);
+			std::swap(z[i], z[k]);
+		}
+	}
+};//namespace tmm
+#endif //__TMM_LINALG_H__
@@ -0,0 +1,87 @@
+#ifndef __TMM_LINEWIDTH_H__
+#define __TMM_LINEWIDTH_H__
+
+/**
+ * \file linewidth.h
+ * \brief source linewidth and detector bandwidth averaging
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <vector>
+#include <cstddef>
+#include <ctl.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Convolution of power spectra with the line shape of the source or detector
+	 * 
+	 * Plans the wavelengths at which a spectrum must be evaluated so that its average over 
+	 * the line shape at every wavelength of the sweep follows as a fixed weighted sum. 
+	 * Uniform sweeps finer than the line are extended by the kernel support and reuse their 
+	 * own samples, so overlapping windows share every evaluation; other sweeps use an 
+	 * oversampled grid shared across the windows, or Gauss-Hermite nodes per wavelength for 
+	 * Gaussian lines when those are fewer.
+	 */
+	class spectral_average
+	{
+		std::vector<double> _points; ///< wavelengths to evaluate
+		std::vector<size_t> _offsets; ///< start of the weights of each sweep wavelength
+		std::vector<size_t> _index; ///< evaluated point of each weight
+		std::vector<double> _weight; ///< normalized kernel weights
+		std::vector<size_t> _nominal; ///< evaluated point at each sweep wavelength, or npos
+	public:
+		static constexpr size_t npos = static_cast<size_t>(-1);
+
+		/**
+		 * \brief Plans the averaging of spectra over ctx.wavelengths
+		 * \param ctx control structure, with ctx.linewidth and ctx.lineshape
+		 */
+		explicit spectral_average(const ctl& ctx);
+
+		/**
+		 * \brief Wavelengths at which the spectrum is evaluated
+		 */
+		const std::vector<double>& points() const { return _points; }
+
+		/**
+		 * \brief Evaluated point coinciding with sweep wavelength k, npos if there is none
+		 */
+		size_t nominal(size_t k) const { return _nominal[k]; }
+
+		/**
+		 * \brief Averaged spectrum at sweep wavelength k
+		 * \param values spectrum at points()
+		 */
+		double operator()(const std::vector<double>& values, size_t k) const
+		{
+			double sum = 0;
+			for (size_t i = _offsets[k]; i < _offsets[k + 1]; ++i)
+				sum += _weight[i] * values[_index[i]];
+			return sum;
+		}
+	};
+};//namespace tmm
+#endif //__TMM_LINEWIDTH_H__
@@ -0,0 +1,99 @@
+#ifndef __TMM_MAPPING_H__
+#define __TMM_MAPPING_H__
+
+/**
+ * \file mapping.h
+ * \brief read-only file mappings
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <cctype>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Read-only memory mapping of a whole file
+	 */
+	class mapping
+	{
+		void* _data = MAP_FAILED;
+		size_t _size = 0;
+	public:
+		mapping(const std::string& path)
+		{
+			int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw std::runtime_error("cannot open " + path);
+			
+			struct stat st;
+			if (::fstat(fd, &st) == 0)
+				_size = st.st_size;
+			
+			if (_size)
+				_data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+			
+			if (_size && _data == MAP_FAILED)
+				throw std::runtime_error("cannot map " + path);
+			
+			if (_size)
+				::madvise(_data, _size, MADV_SEQUENTIAL);
+		}
+		
+		~mapping()
+		{
+			if (_data != MAP_FAILED)
+				::munmap(_data, _size);
+		}
+		
+		mapping(const mapping&) = delete;
+		mapping& operator=(const mapping&) = delete;
+		
+		const char* data() const { return static_cast<const char*>(_data); }
+		size_t size() const { return _size; }
+	};
+
+	/**
+	 * \brief The first bytes of a buffer are printable text
+	 */
+	inline bool is_text(const char* p, size_t n)
+	{
+		for (size_t i = 0; i < std::min<size_t>(n, 256); ++i)
+		{
+			unsigned char c = p[i];
+			if (!std::isprint(c) && !std::isspace(c))
+				return false;
+		}
+		return true;
+	}
+};//namespace tmm
+#endif //__TMM_MAPPING_H__
@@ -0,0 +1,60 @@
+#ifndef __TMM_METRICS_H__
+#define __TMM_METRICS_H__
+
+/**
+ * \file metrics.h
+ * \brief spectral summary metrics
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <vector>
+
+namespace tmm
+{
+	/**
+	 * \brief Summary of a reflection spectrum
+	 */
+	struct summary
+	{
+		double peak = 0; ///< Peak reflectance
+		double center = 0; ///< Wavelength of the peak
+		double bandwidth = 0; ///< Full width at half of the peak reflectance
+		double sidelobe = 0; ///< Largest reflectance outside the main lobe
+	};
+
+	/**
+	 * \brief Summarize a reflection spectrum
+	 * 
+	 * The main lobe extends from the peak through the half maximum crossings to the first 
+	 * minimum on either side. Half maximum crossings are interpolated linearly, a lobe that 
+	 * runs off the grid is cut at the grid end.
+	 * 
+	 * \param wavelengths ascending wavelength grid
+	 * \param R reflectance on the grid
+	 * \returns the summary metrics
+	 */
+	summary summarize(const std::vector<double>& wavelengths, const std::vector<double>& R);
+};//namespace tmm
+#endif //__TMM_METRICS_H__
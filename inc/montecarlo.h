@@ -0,0 +1,67 @@
+#ifndef __TMM_MONTECARLO_H__
+#define __TMM_MONTECARLO_H__
+
+/**
+ * \file montecarlo.h
+ * \brief Monte Carlo yield analysis
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+#include <bragg.h>
+#include <array>
+
+namespace tmm
+{
+	/**
+	 * \brief Offsets of the design variables, indexed by variable_t
+	 */
+	using offset_vector = std::array<double, VAR_SIZE>;
+
+	/**
+	 * \brief Spectrum of the nominal design perturbed by offsets
+	 * 
+	 * The nominal design is the first value of each sweep axis.
+	 * 
+	 * \param ctx control structure
+	 * \param offset offsets of the design variables
+	 * \param R output reflection at each of ctx.wavelengths
+	 * \param T output transmission at each of ctx.wavelengths
+	 */
+	void perturbed_spectrum(const ctl& ctx, const offset_vector& offset, std::vector<double>& R, std::vector<double>& T);
+
+	/**
+	 * \brief Monte Carlo yield analysis
+	 * 
+	 * Draws ctx.samples designs from ctx.variations with a counter-based generator,
+	 * so every sample depends only on its index and the seed. Spectra are reduced on 
+	 * the fly into the yield against ctx.target and per wavelength moments and histograms, 
+	 * from which the quantiles are written to stdout.
+	 * 
+	 * \returns 0 on success
+	 */
+	int montecarlo(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_MONTECARLO_H__
@@ -0,0 +1,75 @@
+#ifndef __TMM_OPTIMIZE_H__
+#define __TMM_OPTIMIZE_H__
+
+/**
+ * \file optimize.h
+ * \brief inverse design of Bragg gratings
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+#include <bragg.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Uniform grating section of a cascaded design
+	 */
+	struct section
+	{
+		double period; ///< The period of the section
+		double duty_cycle; ///< The dutycycle of the section
+		double N; ///< The number of periods in the section
+		double w1; ///< Width of the high index region
+		double w2; ///< Width of the low index region
+	};
+
+	/**
+	 * \brief Spectral objective of a cascade of grating sections
+	 * 
+	 * Sums the mask penalty of ctx.target over ctx.wavelengths. When gradient is given
+	 * the sensitivities to every section parameter are obtained with a single
+	 * reverse-mode pass through the cascade per wavelength.
+	 * 
+	 * \param ctx control structure
+	 * \param sections the sections, cascaded from the input port
+	 * \param gradient optional output, dJ/d(parameter) laid out as sections
+	 * \returns objective value
+	 */
+	double objective(const ctl& ctx, const std::vector<section>& sections, std::vector<section>* gradient = nullptr);
+
+	/**
+	 * \brief Inverse design of a sectioned grating
+	 * 
+	 * Parameters whose sweep axis holds two or more values are optimized within
+	 * [min, max] of the axis, all others are fixed at their first value.
+	 * The optimized sections are written to stdout.
+	 * 
+	 * \param ctx control structure
+	 * \returns 0 on success
+	 */
+	int optimize(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_OPTIMIZE_H__
@@ -0,0 +1,318 @@
+#ifndef __TMM_PARETO_H__
+#define __TMM_PARETO_H__
+
+/**
+ * \file pareto.h
+ * \brief streaming Pareto archive
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+#include <array>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace tmm
+{
+	/**
+	 * \brief Dynamic archive of mutually non-dominated points
+	 * 
+	 * Objectives are minimized. The archive is an ND-tree: every node bounds its points by 
+	 * their ideal and nadir corners, so an update only visits the subtrees whose box can 
+	 * dominate or be dominated by the new point rather than comparing against every member.
+	 * Leaves hold up to `capacity` points and are split at the median of the objective of 
+	 * largest spread.
+	 * 
+	 * \tparam D number of objectives
+	 * \tparam T payload stored with each point
+	 */
+	template<size_t D, typename T>
+	class pareto_archive
+	{
+	public:
+		using objectives = std::array<double, D>;
+
+		explicit pareto_archive(size_t capacity = 16) : _capacity(std::max<size_t>(capacity, 2)) { }
+
+		/**
+		 * \brief Offer a point to the archive
+		 * 
+		 * \returns true if y is non-dominated, the points it dominates are dropped
+		 */
+		bool insert(const objectives& y, const T& value)
+		{
+			if (!_root)
+			{
+				_root = std::make_unique<node>();
+				_root->ideal = _root->nadir = y;
+				_root->points.push_back({y, value});
+				_size = 1;
+				return true;
+			}
+			
+			bool dominated = false;
+			if (update(*_root, y, dominated))
+			{
+				_root = std::make_unique<node>();
+				_root->ideal = _root->nadir = y;
+				_root->points.push_back({y, value});
+				_size = 1;
+				return true;
+			}
+			
+			if (dominated)
+				return false;
+			
+			// Scale of each objective for choosing subtrees
+			objectives scale;
+			for (size_t k = 0; k < D; ++k)
+			{
+				scale[k] = std::max(_root->nadir[k], y[k]) - std::min(_root->ideal[k], y[k]);
+				scale[k] = scale[k] > 0 ? 1.0 / scale[k] : 1.0;
+			}
+			
+			add(*_root, y, value, scale);
+			_size++;
+			return true;
+		}
+
+		/**
+		 * \brief Visit every archived point as f(objectives, value)
+		 */
+		template<typename F>
+		void for_each(F&& f) const
+		{
+			if (_root)
+				visit(*_root, f);
+		}
+
+		size_t size() const { return _size; } ///< Number of archived points
+
+	private:
+		struct node
+		{
+			objectives ideal; ///< componentwise best of the points below
+			objectives nadir; ///< componentwise worst of the points below
+			std::vector<std::pair<objectives, T>> points; ///< points of a leaf
+			std::unique_ptr<node> left, right; ///< children of an internal node
+			
+			bool leaf() const { return !left; }
+		};
+
+		std::unique_ptr<node> _root;
+		size_t _size = 0;
+		size_t _capacity;
+
+		/**
+		 * \brief a is no worse than b in every objective
+		 */
+		static bool covers(const objectives& a, const objectives& b)
+		{
+			for (size_t k = 0; k < D; ++k)
+				if (a[k] > b[k])
+					return false;
+			return true;
+		}
+
+		static size_t count(const node& n)
+		{
+			return n.leaf() ? n.points.size() : count(*n.left) + count(*n.right);
+		}
+
+		static void bound(node& n)
+		{
+			if (n.leaf())
+			{
+				n.ideal = n.nadir = n.points[0].first;
+				for (const auto& [y, _] : n.points)
+					for (size_t k = 0; k < D; ++k)
+					{
+						n.ideal[k] = std::min(n.ideal[k], y[k]);
+						n.nadir[k] = std::max(n.nadir[k], y[k]);
+					}
+				return;
+			}
+			for (size_t k = 0; k < D; ++k)
+			{
+				n.ideal[k] = std::min(n.left->ideal[k], n.right->ideal[k]);
+				n.nadir[k] = std::max(n.left->nadir[k], n.right->nadir[k]);
+			}
+		}
+
+		/**
+		 * \brief Drop the points of n dominated by y, or flag y as dominated
+		 * 
+		 * \returns true if n is left empty
+		 */
+		bool update(node& n, const objectives& y, bool& dominated)
+		{
+			// Every point of n is at least as good as y
+			if (covers(n.nadir, y))
+			{
+				dominated = true;
+				return false;
+			}
+			
+			// y dominates every point of n
+			if (covers(y, n.ideal))
+			{
+				_size -= count(n);
+				return true;
+			}
+			
+			// Neither can a point of n cover y, nor can y cover a point of n
+			if (!covers(n.ideal, y) && !covers(y, n.nadir))
+				return false;
+			
+			if (n.leaf())
+			{
+				for (size_t i = 0; i < n.points.size();)
+				{
+					if (covers(n.points[i].first, y))
+					{
+						dominated = true;
+						return false;
+					}
+					if (covers(y, n.points[i].first))
+					{
+						n.points[i] = std::move(n.points.back());
+						n.points.pop_back();
+						_size--;
+					}
+					else
+						++i;
+				}
+				
+				if (n.points.empty())
+					return true;
+				bound(n);
+				return false;
+			}
+			
+			const bool left = update(*n.left, y, dominated);
+			if (dominated)
+				return false;
+			const bool right = update(*n.right, y, dominated);
+			if (dominated)
+				return false;
+			
+			if (left && right)
+				return true;
+			
+			// Collapse a node left with a single child
+			if (left || right)
+			{
+				std::unique_ptr<node> child = std::move(left ? n.right : n.left);
+				n = std::move(*child);
+				return false;
+			}
+			
+			bound(n);
+			return false;
+		}
+
+		void add(node& n, const objectives& y, const T& value, const objectives& scale)
+		{
+			for (size_t k = 0; k < D; ++k)
+			{
+				n.ideal[k] = std::min(n.ideal[k], y[k]);
+				n.nadir[k] = std::max(n.nadir[k], y[k]);
+			}
+			
+			if (n.leaf())
+			{
+				n.points.push_back({y, value});
+				if (n.points.size() > _capacity)
+					split(n, scale);
+				return;
+			}
+			
+			// Descend into the child whose box centre is nearest
+			auto distance = [&](const node& c)
+			{
+				double d = 0;
+				for (size_t k = 0; k < D; ++k)
+				{
+					const double v = (y[k] - 0.5 * (c.ideal[k] + c.nadir[k])) * scale[k];
+					d += v * v;
+				}
+				return d;
+			};
+			
+			add(distance(*n.left) <= distance(*n.right) ? *n.left : *n.right, y, value, scale);
+		}
+
+		void split(node& n, const objectives& scale)
+		{
+			size_t axis = 0;
+			for (size_t k = 1; k < D; ++k)
+				if ((n.nadir[k] - n.ideal[k]) * scale[k] > (n.nadir[axis] - n.ideal[axis]) * scale[axis])
+					axis = k;
+			
+			auto& p = n.points;
+			const size_t half = p.size() / 2;
+			std::nth_element(p.begin(), p.begin() + half, p.end(), 
+				[axis](const auto& a, const auto& b) { return a.first[axis] < b.first[axis]; });
+			
+			n.left = std::make_unique<node>();
+			n.right = std::make_unique<node>();
+			n.left->points.assign(std::make_move_iterator(p.begin()), std::make_move_iterator(p.begin() + half));
+			n.right->points.assign(std::make_move_iterator(p.begin() + half), std::make_move_iterator(p.end()));
+			p.clear();
+			p.shrink_to_fit();
+			
+			bound(*n.left);
+			bound(*n.right);
+		}
+
+		template<typename F>
+		static void visit(const node& n, F& f)
+		{
+			if (n.leaf())
+			{
+				for (const auto& [y, value] : n.points)
+					f(y, value);
+				return;
+			}
+			visit(*n.left, f);
+			visit(*n.right, f);
+		}
+	};
+
+	/**
+	 * \brief Pareto front of a sweep
+	 * 
+	 * Summarizes the reflection spectrum of every design of the sweep (see designs()) and 
+	 * keeps the designs that are non-dominated in maximum peak reflectance, maximum 
+	 * bandwidth, minimum grating length N * period and minimum sidelobe level. Only 
+	 * the front is written to stdout, in order of decreasing peak reflectance.
+	 * 
+	 * \param ctx control structure
+	 * \returns 0 on success
+	 */
+	int pareto(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_PARETO_H__
@@ -0,0 +1,174 @@
+#ifndef __TMM_PIPELINE_H__
+#define __TMM_PIPELINE_H__
+
+/**
+ * \file pipeline.h
+ * \brief staged pipeline over bounded queues
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <queue.h>
+#include <pool.h>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <utility>
+#include <memory>
+
+namespace tmm
+{
+	/**
+	 * \brief Worker threads of the parallel stages of a pipeline
+	 */
+	struct pipeline_threads
+	{
+		size_t compute = 1; ///< threads running the kernel
+		size_t format = 1; ///< threads formatting results
+	};
+
+	/**
+	 * \brief Staged pipeline of numbered blocks connected by bounded queues
+	 * 
+	 * Blocks 0, 1, ..., n - 1 pass through produce, compute, format and write. produce 
+	 * and write each run on a single thread in block order; compute and format run on 
+	 * their own workers in any order, and the writer restores the order. A fixed set of 
+	 * `capacity` block buffers circulates from the writer back to the producer, so that at 
+	 * most `capacity` blocks are in flight: a slow sink stalls the producer instead of 
+	 * growing memory, and buffers are reused rather than reallocated. The first exception 
+	 * of any stage aborts every stage and is rethrown once all threads have joined.
+	 * 
+	 * \tparam Block block buffer, default constructible, with a size_t member `index`
+	 * \param n number of blocks
+	 * \param capacity block buffers
+	 * \param threads workers of the compute and format stages
+	 * \param produce void(Block&), fills the parameters of block.index
+	 * \param compute void(Block&, size_t thread)
+	 * \param format void(Block&, size_t thread)
+	 * \param write void(Block&)
+	 */
+	template<typename Block, typename P, typename C, typename F, typename W>
+	void pipeline(size_t n, size_t capacity, pipeline_threads threads, P&& produce, C&& compute, F&& format, W&& write)
+	{
+		capacity = std::max<size_t>(std::min(capacity, n), 1);
+		
+		std::vector<Block> blocks(capacity);
+		spsc_queue<Block*> free(capacity); // writer to producer
+		mpmc_queue<Block*> produced(capacity), computed(capacity), formatted(capacity);
+		for (auto& block : blocks)
+			free.try_push(&block);
+		
+		std::exception_ptr error;
+		std::atomic_flag failed = ATOMIC_FLAG_INIT;
+		auto abort = [&]()
+		{
+			if (!failed.test_and_set())
+				error = std::current_exception();
+			free.close();
+			produced.close();
+			computed.close();
+			formatted.close();
+		};
+		
+		std::vector<std::thread> stages;
+		
+		stages.emplace_back([&]()
+		{
+			try
+			{
+				Block* block;
+				for (size_t i = 0; i < n && free.pop(block); ++i)
+				{
+					block->index = i;
+					produce(*block);
+					if (!produced.push(block))
+						break;
+				}
+				produced.close();
+			}
+			catch (...)
+			{
+				abort();
+			}
+		});
+		
+		// Workers of a parallel stage, the last one out closes the output queue
+		auto workers = [&](size_t count, auto& in, auto& out, auto& body)
+		{
+			auto remaining = std::make_shared<std::atomic<size_t>>(count);
+			for (size_t t = 0; t < count; ++t)
+				stages.emplace_back([&abort, in = &in, out = &out, body = &body, t, remaining]()
+				{
+					try
+					{
+						Block* block;
+						while (in->pop(block))
+						{
+							(*body)(*block, t);
+							if (!out->push(block))
+								break;
+						}
+						if (--*remaining == 0)
+							out->close();
+					}
+					catch (...)
+					{
+						abort();
+					}
+				});
+		};
+		workers(std::max<size_t>(threads.compute, 1), produced, computed, compute);
+		workers(std::max<size_t>(threads.format, 1), computed, formatted, format);
+		
+		// The writer holds finished blocks until their predecessors are written
+		try
+		{
+			std::vector<Block*> pending(capacity, nullptr);
+			Block* block;
+			for (size_t next = 0; next < n && formatted.pop(block); )
+			{
+				pending[block->index % capacity] = block;
+				while (next < n && pending[next % capacity])
+				{
+					Block* ready = std::exchange(pending[next % capacity], nullptr);
+					write(*ready);
+					free.push(ready);
+					++next;
+				}
+			}
+		}
+		catch (...)
+		{
+			abort();
+		}
+		
+		for (auto& stage : stages)
+			stage.join();
+		
+		if (error)
+			std::rethrow_exception(error);
+	}
+};//namespace tmm
+#endif //__TMM_PIPELINE_H__
@@ -0,0 +1,183 @@
+#ifndef __TMM_PLAN_H__
+#define __TMM_PLAN_H__
+
+/**
+ * \file plan.h
+ * \brief cost-based planner of Bragg sweeps
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+#include <sampling.h>
+#include <tmm.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+namespace tmm
+{
+	/**
+	 * \brief Kernel evaluating the points of a sweep
+	 */
+	enum kernel_t: uint8_t
+	{
+		KERNEL_SCALAR, ///< one point at a time, any output
+		KERNEL_BATCH, ///< batch_coefficients on SIMD lanes, R, T and phases only
+	};
+
+	/**
+	 * \brief Packing of sweep points onto the lanes of batch kernels
+	 */
+	enum packing_t: uint8_t
+	{
+		PACK_WAVELENGTH, ///< the wavelengths of one design
+		PACK_DESIGN, ///< one wavelength of batch_lanes designs
+	};
+
+	/**
+	 * \brief Algorithm raising the period matrix to N
+	 */
+	enum power_t: uint8_t
+	{
+		POWER_BINARY, ///< matrix_power, O(log N)
+		POWER_CHEBYSHEV, ///< chebyshev_power, O(1)
+	};
+
+	/**
+	 * \brief Evaluation of the layer phases exp(i beta l) of scalar kernels
+	 */
+	enum phase_t: uint8_t
+	{
+		PHASE_DIRECT, ///< complex exponentials at every point
+		PHASE_RECURRENCE, ///< phase_recurrence on uniform wave-number grids
+	};
+
+	/**
+	 * \brief Alternative plan and its estimated cost
+	 */
+	struct plan_candidate
+	{
+		std::string name; ///< description of the plan
+		double cost; ///< estimated evaluation time (s)
+	};
+
+	/**
+	 * \brief Execution plan of a Bragg sweep
+	 * 
+	 * Rows are always written in the order of the design points, wavelengths innermost; 
+	 * the plan decides in which order and by which kernels they are evaluated.
+	 */
+	struct sweep_plan
+	{
+		kernel_t kernel = KERNEL_SCALAR; ///< evaluation kernel
+		packing_t packing = PACK_WAVELENGTH; ///< lane packing of batch kernels
+		power_t power = POWER_BINARY; ///< power algorithm of scalar kernels
+		phase_t phase = PHASE_DIRECT; ///< layer phases of scalar kernels
+		bool period_cache = false; ///< period matrices of the first N reused along the N axis
+		bool tables[3] = {}; ///< n1, n2 and loss tabulated over the wavelengths and widths
+		double evaluation = 0; ///< estimated evaluation time (s)
+		double output = 0; ///< estimated time writing the rows (s)
+		std::vector<plan_candidate> candidates; ///< every feasible plan, cheapest first
+	};
+
+	/**
+	 * \brief Chooses the cheapest plan of a Bragg sweep
+	 * 
+	 * Feasible combinations of kernel, packing, power algorithm, layer phases and 
+	 * period-matrix cache are costed from the sweep shape, the N of a bounded sample of 
+	 * the designs and the material models, with per-operation costs measured on the 
+	 * reference build. 
+	 * Material tables are built where their cost is recovered by the lookups they replace.
+	 * 
+	 * \param ctx control structure
+	 * \param points design points of the sweep
+	 * \returns the plan
+	 */
+	sweep_plan plan_sweep(const ctl& ctx, const design_set& points);
+
+	/**
+	 * \brief Whether the layer phases of a design follow a uniform wave-number grid
+	 * 
+	 * phase_recurrence applies the offsets of the wave numbers from the grid to second 
+	 * order, so they are kept below 1e-4 rad per layer.
+	 * 
+	 * \param ctx control structure, with non-dispersive materials
+	 * \param grid wave-number grid of the sweep
+	 * \param d the design
+	 */
+	bool recurrent(const ctl& ctx, const wavenumber_grid& grid, const design& d);
+
+	/**
+	 * \brief Writes a plan and its alternatives in readable form
+	 * 
+	 * \param ctx control structure
+	 * \param points design points of the sweep
+	 * \param plan the plan
+	 * \param out stream written to
+	 */
+	void explain(const ctl& ctx, const design_set& points, const sweep_plan& plan, FILE* out);
+
+	/**
+	 * \brief Material property of a sweep, evaluated directly or tabulated
+	 * 
+	 * Tables hold the property at every wavelength of the sweep for every distinct width 
+	 * of the design points, or for a single width when the model does not depend on it.
+	 */
+	class material
+	{
+		const cml& _model; ///< the material model
+		const std::vector<double>& _wavelengths; ///< wavelengths of the sweep
+		double design::* _width; ///< width the model is evaluated at, nullptr for none
+		std::vector<double> _widths; ///< distinct widths of the table rows, sorted
+		std::vector<double> _values; ///< rows x wavelengths, empty when evaluated directly
+	public:
+		/**
+		 * \param model the material model
+		 * \param wavelengths wavelengths of the sweep
+		 * \param points design points of the sweep
+		 * \param width width of the design points the model is evaluated at, nullptr for none
+		 * \param tabulate build the table
+		 */
+		material(const cml& model, const std::vector<double>& wavelengths, const design_set& points, 
+			double design::* width, bool tabulate);
+
+		/**
+		 * \brief Table row of a design point
+		 */
+		size_t row(const design& d) const;
+
+		/**
+		 * \brief Property of design point d, table row `row`, at wavelength k
+		 */
+		double operator()(const design& d, size_t row, size_t k) const
+		{
+			if (_values.empty())
+				return _model(_wavelengths[k], _width ? d.*_width : 0.0, k);
+			
+			return _values[row * _wavelengths.size() + k];
+		}
+	};
+};//namespace tmm
+#endif //__TMM_PLAN_H__
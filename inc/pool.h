@@ -0,0 +1,105 @@
+#ifndef __TMM_POOL_H__
+#define __TMM_POOL_H__
+
+/**
+ * \file pool.h
+ * \brief thread parallel loops
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <exception>
+
+namespace tmm
+{
+	/**
+	 * \brief Number of worker threads to use
+	 * \param requested explicit thread count, 0 selects the hardware concurrency
+	 */
+	inline size_t concurrency(size_t requested = 0)
+	{
+		if (requested)
+			return requested;
+		return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+
+	/**
+	 * \brief Dynamically scheduled parallel loop
+	 * 
+	 * Calls f(i, thread) for i in [0, n) on up to `threads` workers. Work items are 
+	 * handed out one at a time, so f may be arbitrarily unbalanced. The first exception
+	 * thrown by f is rethrown on the calling thread once all workers have joined.
+	 * 
+	 * \tparam F callable void(size_t i, size_t thread)
+	 * \param n number of work items
+	 * \param f loop body
+	 * \param threads worker count, 0 selects the hardware concurrency
+	 */
+	template<typename F>
+	void parallel_for(size_t n, F&& f, size_t threads = 0)
+	{
+		threads = std::min(concurrency(threads), n);
+		
+		if (threads <= 1)
+		{
+			for (size_t i = 0; i < n; ++i)
+				f(i, 0);
+			return;
+		}
+		
+		std::atomic<size_t> next{0};
+		std::exception_ptr error;
+		std::atomic_flag failed = ATOMIC_FLAG_INIT;
+		std::vector<std::thread> workers;
+		
+		for (size_t t = 0; t < threads; ++t)
+		{
+			workers.emplace_back([&, t]()
+			{
+				try
+				{
+					for (size_t i = next++; i < n; i = next++)
+						f(i, t);
+				}
+				catch (...)
+				{
+					if (!failed.test_and_set())
+						error = std::current_exception();
+					next = n;
+				}
+			});
+		}
+		
+		for (auto& w : workers)
+			w.join();
+		
+		if (error)
+			std::rethrow_exception(error);
+	}
+};//namespace tmm
+#endif //__TMM_POOL_H__
@@ -0,0 +1,128 @@
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+/**
+ * \file profile.h
+ * \brief arbitrary index profiles
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <tmm.h>
+#include <vector>
+#include <string>
+#include <array>
+
+namespace tmm
+{
+	/**
+	 * \brief Homogeneous layer of an index profile
+	 */
+	struct layer
+	{
+		double length; ///< Length of the layer
+		double n; ///< Effective index of the layer
+		double loss; ///< Loss of the layer
+	};
+
+	/**
+	 * \brief Arbitrary layered index profile.
+	 * 
+	 * The layers are loaded from a memory mapped file and compressed once, independent of 
+	 * the wavelength: identical layers are hash-consed into unit elements, runs of a repeated 
+	 * group of up to max_group elements collapse into a single matrix_power, and the remaining 
+	 * literal layers are packed into groups. The ordered product of the segments is a 
+	 * multithreaded tree reduction. The profile is embedded in the index of its first layer.
+	 */
+	class Profile : protected TMM
+	{
+		/**
+		 * \brief Group of unit elements raised to a power
+		 */
+		struct power
+		{
+			uint32_t group; ///< index into _groups
+			uint64_t count; ///< repetitions of the group
+		};
+
+		std::vector<std::array<double, 4>> _elements; ///< distinct (length, n, loss, next n) unit elements
+		std::vector<std::vector<uint32_t>> _groups; ///< distinct groups of elements
+		std::vector<power> _powers; ///< distinct powers of groups
+		std::vector<uint32_t> _segments; ///< the profile as a sequence of powers
+		size_t _layers = 0; ///< number of layers in the file
+
+		/**
+		 * \brief Compress the layer sequence into segments
+		 */
+		void compress(const std::vector<layer>& layers, size_t max_group);
+
+		/**
+		 * \brief Ordered product of the segment matrices, normalized
+		 * \returns natural log of the scale removed from T
+		 */
+		double product(std::complex<double>** T, double wavelength, size_t threads);
+	public:
+
+		/**
+		 * \brief Load a profile
+		 * 
+		 * Text files hold one "length,n,loss" layer per line, lines that do not start with a 
+		 * number are skipped. Binary files are a sequence of (length, n, loss) float64 triples 
+		 * in native byte order.
+		 * 
+		 * \param path the layer file
+		 * \param max_group longest repeated group that is detected
+		 */
+		Profile(const std::string& path, size_t max_group = 64);
+
+		/**
+		 * \brief Compute transfer matrix of the profile
+		 * 
+		 * \param T Output 2x2 transfer matrix
+		 * \param wavelength Wavelength in meters
+		 * \param threads Worker threads for the product, 0 for all cores
+		 */
+		void scattering_matrix(std::complex<double>** T, double wavelength, size_t threads = 0);
+
+		/**
+		 * \brief Compute reflection and transmission at single wavelength
+		 * 
+		 * \returns reflection and transmission coefficients and phases
+		 */
+		std::tuple<double, double, double, double> scattering_coefficients(double wavelength, size_t threads = 0);
+
+		/**
+		 * \brief Compute the full scattering parameters at single wavelength
+		 * 
+		 * \returns S11, S21, S12 and S22 from one transfer matrix
+		 */
+		sparameters scattering_parameters(double wavelength, size_t threads = 0);
+
+		size_t layers() const { return _layers; } ///< Number of layers
+		size_t elements() const { return _elements.size(); } ///< Number of distinct layers
+		size_t groups() const { return _groups.size(); } ///< Number of distinct groups
+		size_t segments() const { return _segments.size(); } ///< Number of segments in the product
+	};
+}//namespace tmm
+#endif //__PROFILE_H__
@@ -0,0 +1,50 @@
+#ifndef __TMM_PULSE_H__
+#define __TMM_PULSE_H__
+
+/**
+ * \file pulse.h
+ * \brief time-domain pulse response
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Reflected and transmitted pulses of the nominal grating
+	 * 
+	 * The complex r and t are evaluated on a uniform frequency grid of ctx.fft_size points 
+	 * spanning the ctx.wavelengths window, multiplied by the spectrum of a Gaussian input 
+	 * pulse at ctx.carrier and an optional window, zero-padded by ctx.pad and transformed 
+	 * to the time domain with fft. The envelopes are written relative to the peak of the 
+	 * input pulse.
+	 * 
+	 * \param ctx control structure
+	 * \returns 0 on success
+	 */
+	int pulse(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_PULSE_H__
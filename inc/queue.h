@@ -0,0 +1,265 @@
+#ifndef __TMM_QUEUE_H__
+#define __TMM_QUEUE_H__
+
+/**
+ * \file queue.h
+ * \brief bounded lock-free queues
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <bit>
+#include <cstdint>
+
+namespace tmm
+{
+	namespace detail
+	{
+		constexpr size_t cache_line = 64; ///< separation of indices written by different threads
+
+		/**
+		 * \brief Waiting of blocked queue operations, spinning first, then yielding, then sleeping
+		 */
+		class backoff
+		{
+			unsigned _step = 0;
+		public:
+			void operator()()
+			{
+				if (_step >= 64)
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+				else if (_step >= 16)
+					std::this_thread::yield();
+				++_step;
+			}
+		};
+	}
+
+	/**
+	 * \brief Bounded lock-free queue of one producer and one consumer
+	 * 
+	 * A ring of power-of-two capacity indexed by free-running head and tail counters, 
+	 * each written by one side only. push blocks while the queue is full, which is the 
+	 * back-pressure of a slow consumer on its producer.
+	 * 
+	 * \tparam T element type, default constructible and movable
+	 */
+	template<typename T>
+	class spsc_queue
+	{
+		std::vector<T> _slots; ///< ring storage
+		size_t _mask; ///< capacity - 1
+		alignas(detail::cache_line) std::atomic<size_t> _head{0}; ///< next slot read, written by the consumer
+		alignas(detail::cache_line) std::atomic<size_t> _tail{0}; ///< next slot written, written by the producer
+		alignas(detail::cache_line) std::atomic<bool> _closed{false}; ///< no further pushes
+	public:
+		/**
+		 * \param capacity least capacity, rounded up to a power of two
+		 */
+		explicit spsc_queue(size_t capacity) : 
+		_slots(std::bit_ceil(std::max<size_t>(capacity, 1))), _mask(_slots.size() - 1)
+		{ }
+
+		/**
+		 * \brief Appends v unless the queue is full
+		 */
+		bool try_push(T v)
+		{
+			const size_t tail = _tail.load(std::memory_order_relaxed);
+			if (tail - _head.load(std::memory_order_acquire) > _mask)
+				return false;
+			
+			_slots[tail & _mask] = std::move(v);
+			_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * \brief Removes the oldest element into v unless the queue is empty
+		 */
+		bool try_pop(T& v)
+		{
+			const size_t head = _head.load(std::memory_order_relaxed);
+			if (head == _tail.load(std::memory_order_acquire))
+				return false;
+			
+			v = std::move(_slots[head & _mask]);
+			_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * \brief Appends v, waiting while the queue is full
+		 * \returns false if the queue was closed
+		 */
+		bool push(T v)
+		{
+			for (detail::backoff wait; !try_push(v); wait())
+				if (_closed.load(std::memory_order_acquire))
+					return false;
+			return true;
+		}
+
+		/**
+		 * \brief Removes the oldest element into v, waiting while the queue is empty
+		 * \returns false once the queue is closed and drained
+		 */
+		bool pop(T& v)
+		{
+			for (detail::backoff wait; !try_pop(v); wait())
+				if (_closed.load(std::memory_order_acquire))
+					return try_pop(v);
+			return true;
+		}
+
+		/**
+		 * \brief Ends the stream, called by the producer after its last push or to abort
+		 */
+		void close() { _closed.store(true, std::memory_order_release); }
+	};
+
+	/**
+	 * \brief Bounded lock-free queue of many producers and consumers
+	 * 
+	 * Vyukov's bounded queue: each cell carries a sequence number telling producers and 
+	 * consumers whose turn it is, and positions are claimed by compare-and-swap on the 
+	 * enqueue and dequeue counters. push blocks while the queue is full.
+	 * 
+	 * \tparam T element type, default constructible and movable
+	 */
+	template<typename T>
+	class mpmc_queue
+	{
+		struct alignas(detail::cache_line) cell
+		{
+			std::atomic<size_t> sequence; ///< position the cell is next written (== pos) or read (== pos + 1) at
+			T value;
+		};
+		
+		std::unique_ptr<cell[]> _cells; ///< ring storage
+		size_t _mask; ///< capacity - 1
+		alignas(detail::cache_line) std::atomic<size_t> _enqueue{0}; ///< next position written
+		alignas(detail::cache_line) std::atomic<size_t> _dequeue{0}; ///< next position read
+		alignas(detail::cache_line) std::atomic<bool> _closed{false}; ///< no further pushes
+	public:
+		/**
+		 * \param capacity least capacity, rounded up to a power of two of at least 2
+		 */
+		explicit mpmc_queue(size_t capacity) : 
+		_cells(new cell[std::bit_ceil(std::max<size_t>(capacity, 2))]), _mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1)
+		{
+			for (size_t i = 0; i <= _mask; ++i)
+				_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		/**
+		 * \brief Appends v unless the queue is full
+		 */
+		bool try_push(T v)
+		{
+			size_t pos = _enqueue.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				cell& c = _cells[pos & _mask];
+				const auto turn = static_cast<intptr_t>(c.sequence.load(std::memory_order_acquire) - pos);
+				
+				if (turn == 0)
+				{
+					if (_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					{
+						c.value = std::move(v);
+						c.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (turn < 0)
+					return false;
+				else
+					pos = _enqueue.load(std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * \brief Removes the oldest element into v unless the queue is empty
+		 */
+		bool try_pop(T& v)
+		{
+			size_t pos = _dequeue.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				cell& c = _cells[pos & _mask];
+				const auto turn = static_cast<intptr_t>(c.sequence.load(std::memory_order_acquire) - (pos + 1));
+				
+				if (turn == 0)
+				{
+					if (_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					{
+						v = std::move(c.value);
+						c.sequence.store(pos + _mask + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (turn < 0)
+					return false;
+				else
+					pos = _dequeue.load(std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * \brief Appends v, waiting while the queue is full
+		 * \returns false if the queue was closed
+		 */
+		bool push(T v)
+		{
+			for (detail::backoff wait; !try_push(v); wait())
+				if (_closed.load(std::memory_order_acquire))
+					return false;
+			return true;
+		}
+
+		/**
+		 * \brief Removes the oldest element into v, waiting while the queue is empty
+		 * \returns false once the queue is closed and drained
+		 */
+		bool pop(T& v)
+		{
+			for (detail::backoff wait; !try_pop(v); wait())
+				if (_closed.load(std::memory_order_acquire))
+					return try_pop(v);
+			return true;
+		}
+
+		/**
+		 * \brief Ends the stream, called once every producer has finished or to abort
+		 */
+		void close() { _closed.store(true, std::memory_order_release); }
+	};
+};//namespace tmm
+#endif //__TMM_QUEUE_H__
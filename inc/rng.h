@@ -0,0 +1,116 @@
+#ifndef __TMM_RNG_H__
+#define __TMM_RNG_H__
+
+/**
+ * \file rng.h
+ * \brief counter-based random numbers
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <array>
+#include <cstdint>
+#include <cmath>
+
+namespace tmm
+{
+	/**
+	 * \brief Philox4x32-10 counter-based random number generator
+	 * 
+	 * Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11.
+	 * Each (counter, key) pair maps to four independent 32-bit words, so any
+	 * sample can be drawn directly from its index without sequential state.
+	 */
+	class philox
+	{
+		static constexpr uint32_t M0 = 0xD2511F53;
+		static constexpr uint32_t M1 = 0xCD9E8D57;
+		static constexpr uint32_t W0 = 0x9E3779B9;
+		static constexpr uint32_t W1 = 0xBB67AE85;
+		
+		std::array<uint32_t, 2> _key;
+	public:
+		using counter_t = std::array<uint32_t, 4>;
+
+		explicit philox(uint64_t seed) : 
+		_key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)} 
+		{ }
+
+		/**
+		 * \brief Random words for a counter
+		 */
+		counter_t operator()(counter_t ctr) const
+		{
+			std::array<uint32_t, 2> key = _key;
+			
+			for (int round = 0; round < 10; ++round)
+			{
+				uint64_t p0 = static_cast<uint64_t>(M0) * ctr[0];
+				uint64_t p1 = static_cast<uint64_t>(M1) * ctr[2];
+				
+				ctr = counter_t{
+					static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+					static_cast<uint32_t>(p1),
+					static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+					static_cast<uint32_t>(p0)
+				};
+				
+				key[0] += W0;
+				key[1] += W1;
+			}
+			
+			return ctr;
+		}
+
+		/**
+		 * \brief Two uniform doubles in (0, 1) for stream `stream` at index `index`
+		 */
+		std::array<double, 2> uniform(uint64_t index, uint64_t stream) const
+		{
+			auto r = (*this)(counter_t{
+				static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32),
+				static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)
+			});
+			
+			// 53 random bits, offset by half an ulp to exclude 0
+			auto to_double = [](uint32_t hi, uint32_t lo)
+			{
+				uint64_t bits = (static_cast<uint64_t>(hi) << 21) ^ (lo >> 11);
+				return (static_cast<double>(bits) + 0.5) * 0x1.0p-53;
+			};
+			
+			return {to_double(r[0], r[1]), to_double(r[2], r[3])};
+		}
+
+		/**
+		 * \brief Standard normal double for stream `stream` at index `index`
+		 */
+		double normal(uint64_t index, uint64_t stream) const
+		{
+			auto [u1, u2] = uniform(index, stream);
+			return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+		}
+	};
+};//namespace tmm
+#endif //__TMM_RNG_H__
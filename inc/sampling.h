@@ -0,0 +1,106 @@
+#ifndef __TMM_SAMPLING_H__
+#define __TMM_SAMPLING_H__
+
+/**
+ * \file sampling.h
+ * \brief design space sampling
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Point of the design space evaluated by a sweep
+	 */
+	struct design
+	{
+		double period; ///< The grating period
+		double duty_cycle; ///< The dutycycle
+		double N; ///< The number of periods
+		double w1; ///< Width of the high index region, 0 when not swept
+		double w2; ///< Width of the low index region, 0 when not swept
+	};
+
+	/**
+	 * \brief Design points of a sweep
+	 * 
+	 * CARTESIAN enumerates every combination of the axes, period outermost and w2 innermost. 
+	 * The combinations are not stored: design i is decoded from the axis sizes when it is read, 
+	 * so a sweep of any size needs memory for its axes only. SOBOL and LHS draw ctx.samples 
+	 * space-filling points within [min, max] of every axis that holds two or more values, with 
+	 * N rounded to the nearest integer, and store them. Axes holding a single value are fixed. 
+	 * Sobol points are digitally shifted and LHS strata are permuted with ctx.seed.
+	 */
+	class design_set
+	{
+		std::vector<double> _period, _duty_cycle, _N, _w1, _w2; ///< cartesian axes, widths {0} when not swept
+		std::vector<design> _points; ///< sampled designs
+		bool _cartesian; ///< designs are decoded from the axes
+		size_t _size; ///< number of designs
+	public:
+		/**
+		 * \param ctx control structure
+		 */
+		explicit design_set(const ctl& ctx);
+
+		/**
+		 * \brief Number of designs
+		 */
+		size_t size() const { return _size; }
+
+		/**
+		 * \brief Design i
+		 */
+		design operator[](size_t i) const
+		{
+			if (!_cartesian)
+				return _points[i];
+			
+			design d;
+			d.w2 = _w2[i % _w2.size()]; i /= _w2.size();
+			d.w1 = _w1[i % _w1.size()]; i /= _w1.size();
+			d.N = _N[i % _N.size()]; i /= _N.size();
+			d.duty_cycle = _duty_cycle[i % _duty_cycle.size()]; i /= _duty_cycle.size();
+			d.period = _period[i];
+			return d;
+		}
+
+		/**
+		 * \brief Distinct values of a field over the designs, sorted
+		 */
+		std::vector<double> distinct(double design::* field) const;
+	};
+
+	/**
+	 * \brief Design points of a sweep, see design_set
+	 * 
+	 * \param ctx control structure
+	 * \returns the design points
+	 */
+	inline design_set designs(const ctl& ctx) { return design_set(ctx); }
+};//namespace tmm
+#endif //__TMM_SAMPLING_H__
@@ -0,0 +1,56 @@
+#ifndef __TMM_SEARCH_H__
+#define __TMM_SEARCH_H__
+
+/**
+ * \file search.h
+ * \brief hierarchical design space search
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Coarse-to-fine search of the design space for designs meeting a spectral mask
+	 * 
+	 * The axes holding two or more values span the search box [min, max]. A grid of ctx.grid 
+	 * points per axis is scored with the mask penalty of ctx.target at the cell corners, then 
+	 * cells are bisected for ctx.depth levels. A cell is dropped when every corner meets the 
+	 * mask (it is reported as feasible), or when the Bloch-trace estimate of the reflection at 
+	 * its corners stays below an R_min of the mask for every N in the cell. Of the other cells 
+	 * only those are refined that have a passing corner, that share a face with a cell having 
+	 * one, or whose smallest corner penalty is below a threshold. The threshold starts at the 
+	 * median smallest penalty of the coarse cells without a passing corner and halves with 
+	 * the cell edge. Both tests are heuristics on the corners only: a feasible pocket inside 
+	 * a cell, away from any passing design and with large penalties at the corners, is missed. 
+	 * Passing designs are written to stdout.
+	 * 
+	 * \param ctx control structure
+	 * \returns 0 on success
+	 */
+	int search(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_SEARCH_H__
@@ -0,0 +1,402 @@
+#ifndef __TMM_SHM_H__
+#define __TMM_SHM_H__
+
+/**
+ * \file shm.h
+ * \brief shared memory result rings
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <queue.h>
+#include <atomic>
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <signal.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Result record of a sweep point, the element of shared memory rings
+	 * 
+	 * Fields the sweep does not compute are NaN, and shm_header::fields tells which 
+	 * are set. The layout is 22 native-endian doubles, 176 bytes, without padding.
+	 */
+	struct shm_record
+	{
+		double period, duty_cycle, N, wavelength; ///< design point, always set
+		double w1, w2; ///< swept widths
+		double n1, n2, loss; ///< materials at the wavelength
+		double R, T, phase_r, phase_t, group_delay; ///< spectral columns
+		double S11[2], S21[2], S12[2], S22[2]; ///< real and imaginary parts of the scattering parameters
+	};
+	static_assert(sizeof(shm_record) == 22 * sizeof(double));
+
+	/**
+	 * \brief Names of the shm_record fields, bit i of shm_header::fields flags the i-th, 
+	 * the scattering parameters one bit each
+	 */
+	inline constexpr const char* shm_field_names[] = {
+		"period", "duty_cycle", "N", "wavelength", "w1", "w2", "n1", "n2", "loss", 
+		"R", "T", "phase_r", "phase_t", "group_delay", "S11", "S21", "S12", "S22"
+	};
+
+	/**
+	 * \brief Life cycle of a shared memory ring, shm_header::state
+	 */
+	enum shm_state_t: uint32_t
+	{
+		SHM_RUNNING, ///< the producer is publishing records
+		SHM_DONE, ///< every record is published
+		SHM_FAILED, ///< the producer stopped early, published records are valid
+	};
+
+	/**
+	 * \brief Header at offset 0 of a shared memory ring, followed by the records at offset 256
+	 * 
+	 * Protocol, for one producer and one consumer: head and tail count records published 
+	 * and consumed since the start. Record i lives in slot i % capacity. The producer 
+	 * writes slots [head, tail + capacity) and then stores head with release order; the 
+	 * consumer loads head with acquire order, reads slots [tail, head) and then stores 
+	 * tail with release order, freeing them. The producer stores state after its final 
+	 * head, so a consumer that sees a state other than SHM_RUNNING and then tail == head 
+	 * has read every record. A producer with no consumer blocks once the ring is full.
+	 * 
+	 * The producer initializes every field before storing version, and a consumer 
+	 * opening the object waits for version to be nonzero. A producer killed before 
+	 * storing state is detected by the consumer from pid. The consumer stores its own 
+	 * process id in consumer when it attaches and -1 when it detaches, and a producer 
+	 * waiting on a full ring gives up when the consumer detached or died, or when none 
+	 * attached within its timeout.
+	 */
+	struct shm_header
+	{
+		char magic[8]; ///< "TMMRING"
+		std::atomic<uint32_t> version; ///< layout version, 1, stored last by the producer
+		uint32_t record_size; ///< sizeof(shm_record)
+		uint64_t capacity; ///< records in the ring, a power of two
+		uint64_t records; ///< records the producer will publish
+		uint32_t fields; ///< shm_field_names flags of the fields set
+		int32_t pid; ///< process id of the producer
+		alignas(detail::cache_line) std::atomic<uint64_t> head; ///< records published, written by the producer
+		alignas(detail::cache_line) std::atomic<uint64_t> tail; ///< records consumed, written by the consumer
+		std::atomic<int32_t> consumer; ///< process id of the consumer, 0 before it attaches, -1 after it detaches
+		alignas(detail::cache_line) std::atomic<uint32_t> state; ///< shm_state_t, written by the producer
+	};
+	static_assert(sizeof(shm_header) == 256);
+	static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+	inline constexpr char shm_magic[8] = "TMMRING"; ///< shm_header::magic
+	inline constexpr uint32_t shm_version = 1; ///< shm_header::version
+
+	namespace detail
+	{
+		/**
+		 * \brief Mapping of a shared memory ring
+		 */
+		class shm_mapping
+		{
+		protected:
+			void* _map = nullptr; ///< the whole object
+			size_t _size = 0; ///< bytes mapped
+
+			shm_header& header() const { return *static_cast<shm_header*>(_map); }
+			shm_record* records() const { return reinterpret_cast<shm_record*>(static_cast<char*>(_map) + sizeof(shm_header)); }
+
+			void map(int fd, size_t size)
+			{
+				_map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				if (_map == MAP_FAILED)
+				{
+					_map = nullptr;
+					throw std::runtime_error(std::string("shm: mmap: ") + std::strerror(errno));
+				}
+				_size = size;
+			}
+		public:
+			shm_mapping() = default;
+			shm_mapping(const shm_mapping&) = delete;
+			shm_mapping& operator=(const shm_mapping&) = delete;
+			~shm_mapping()
+			{
+				if (_map)
+					munmap(_map, _size);
+			}
+		};
+	}
+
+	/**
+	 * \brief Producer side of a shared memory ring
+	 * 
+	 * Creates the POSIX shared memory object, failing if one of the same name exists 
+	 * unless replace is set. The object outlives the producer, and is removed by the 
+	 * consumer with shm_unlink. Destroying a producer before close marks the ring SHM_FAILED.
+	 */
+	class shm_producer : public detail::shm_mapping
+	{
+		uint64_t _head = 0; ///< records published
+		bool _closed = false; ///< state is final
+		double _timeout; ///< seconds a full ring waits for a consumer to attach
+	public:
+		/**
+		 * \param name shared memory object name, "/name"
+		 * \param capacity least records in the ring, rounded up to a power of two
+		 * \param records records that will be published
+		 * \param fields shm_field_names flags of the fields set
+		 * \param replace remove an existing object of the same name first
+		 * \param timeout seconds a full ring waits for a consumer to attach
+		 */
+		shm_producer(const std::string& name, size_t capacity, uint64_t records, uint32_t fields, 
+			bool replace = false, double timeout = 10) : 
+		_timeout(timeout)
+		{
+			capacity = std::bit_ceil(std::max<size_t>(capacity, 1));
+			
+			if (replace)
+				shm_unlink(name.c_str());
+			const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+			if (fd == -1 && errno == EEXIST)
+				throw std::runtime_error("shm: " + name + " exists, remove it or replace it explicitly");
+			if (fd == -1)
+				throw std::runtime_error("shm: open " + name + ": " + std::strerror(errno));
+			
+			const size_t size = sizeof(shm_header) + capacity * sizeof(shm_record);
+			if (ftruncate(fd, static_cast<off_t>(size)) == -1)
+			{
+				const int error = errno;
+				::close(fd);
+				shm_unlink(name.c_str());
+				throw std::runtime_error(std::string("shm: ftruncate: ") + std::strerror(error));
+			}
+			
+			try
+			{
+				map(fd, size);
+			}
+			catch (...)
+			{
+				::close(fd);
+				shm_unlink(name.c_str());
+				throw;
+			}
+			::close(fd);
+			
+			// The object is zero-filled, so version stays 0 until the header is complete
+			auto& h = header();
+			std::memcpy(h.magic, shm_magic, sizeof h.magic);
+			h.record_size = sizeof(shm_record);
+			h.capacity = capacity;
+			h.records = records;
+			h.fields = fields;
+			h.pid = getpid();
+			h.version.store(shm_version, std::memory_order_release);
+		}
+
+		~shm_producer()
+		{
+			if (_map && !_closed)
+				header().state.store(SHM_FAILED, std::memory_order_release);
+		}
+
+		/**
+		 * \brief Free slots following the published records, waiting for at least one
+		 * 
+		 * The span is contiguous, so it ends at the end of the ring, and holds at most 
+		 * wanted records. Records written to it are published by publish.
+		 */
+		std::span<shm_record> reserve(size_t wanted)
+		{
+			auto& h = header();
+			uint64_t free;
+			size_t waits = 0;
+			std::chrono::steady_clock::time_point deadline{};
+			for (detail::backoff wait; (free = h.capacity - (_head - h.tail.load(std::memory_order_acquire))) == 0; wait(), ++waits)
+			{
+				// The consumer may have gone, checked between sleeps
+				if (waits % 64 != 63)
+					continue;
+				
+				const int32_t consumer = h.consumer.load(std::memory_order_acquire);
+				if (consumer == -1)
+					throw std::runtime_error("shm: the consumer detached before reading every record");
+				if (consumer > 0 && kill(consumer, 0) == -1 && errno == ESRCH)
+					throw std::runtime_error("shm: the consumer exited before reading every record");
+				if (consumer == 0)
+				{
+					const auto now = std::chrono::steady_clock::now();
+					if (deadline == std::chrono::steady_clock::time_point{})
+						deadline = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(_timeout));
+					else if (now > deadline)
+						throw std::runtime_error("shm: no consumer attached to the full ring");
+				}
+			}
+			
+			const size_t slot = _head & (h.capacity - 1);
+			return {records() + slot, std::min<size_t>({wanted, free, h.capacity - slot})};
+		}
+
+		/**
+		 * \brief Publishes the first count records of the last reservation
+		 */
+		void publish(size_t count)
+		{
+			_head += count;
+			header().head.store(_head, std::memory_order_release);
+		}
+
+		/**
+		 * \brief Marks every record published
+		 */
+		void close()
+		{
+			header().state.store(SHM_DONE, std::memory_order_release);
+			_closed = true;
+		}
+	};
+
+	/**
+	 * \brief Consumer side of a shared memory ring
+	 */
+	class shm_consumer : public detail::shm_mapping
+	{
+		uint64_t _tail = 0; ///< records consumed
+	public:
+		/**
+		 * \param name shared memory object name, "/name"
+		 * \param timeout seconds to wait for the producer to create the ring
+		 */
+		explicit shm_consumer(const std::string& name, double timeout = 10)
+		{
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+			
+			// Wait for the object, its size and its header
+			int fd;
+			struct stat st{};
+			for (;;)
+			{
+				fd = shm_open(name.c_str(), O_RDWR, 0);
+				if (fd != -1 && fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(shm_header))
+					break;
+				if (fd == -1 && errno != ENOENT)
+					throw std::runtime_error("shm: open " + name + ": " + std::strerror(errno));
+				if (fd != -1)
+					::close(fd);
+				if (std::chrono::steady_clock::now() > deadline)
+					throw std::runtime_error("shm: open " + name + ": timed out waiting for the producer");
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+			
+			try
+			{
+				map(fd, static_cast<size_t>(st.st_size));
+			}
+			catch (...)
+			{
+				::close(fd);
+				throw;
+			}
+			::close(fd);
+			
+			auto& h = header();
+			for (detail::backoff wait; h.version.load(std::memory_order_acquire) == 0; wait())
+				if (std::chrono::steady_clock::now() > deadline)
+					throw std::runtime_error("shm: " + name + ": timed out waiting for the header");
+			
+			if (std::memcmp(h.magic, shm_magic, sizeof h.magic) || h.version.load(std::memory_order_relaxed) != shm_version 
+				|| h.record_size != sizeof(shm_record) || sizeof(shm_header) + h.capacity * sizeof(shm_record) > _size)
+				throw std::runtime_error("shm: " + name + ": not a version 1 result ring");
+			
+			// One consumer per ring
+			int32_t none = 0;
+			if (!h.consumer.compare_exchange_strong(none, getpid(), std::memory_order_acq_rel))
+				throw std::runtime_error("shm: " + name + " already has a consumer");
+			
+			_tail = h.tail.load(std::memory_order_relaxed);
+		}
+
+		~shm_consumer()
+		{
+			if (_map)
+				header().consumer.store(-1, std::memory_order_release);
+		}
+
+		const shm_header& info() const { return header(); }
+
+		/**
+		 * \brief Published records not yet consumed, waiting for at least one
+		 * 
+		 * The span is contiguous, so it ends at the end of the ring. An empty span 
+		 * means the producer finished, with state() telling how.
+		 */
+		std::span<const shm_record> acquire()
+		{
+			auto& h = header();
+			uint64_t head;
+			size_t waits = 0;
+			for (detail::backoff wait; (head = h.head.load(std::memory_order_acquire)) == _tail; wait(), ++waits)
+			{
+				// The producer may have died without storing its state, checked between sleeps
+				if (waits % 64 == 63 && kill(h.pid, 0) == -1 && errno == ESRCH)
+					h.state.store(SHM_FAILED, std::memory_order_release);
+				
+				if (h.state.load(std::memory_order_acquire) != SHM_RUNNING)
+				{
+					if ((head = h.head.load(std::memory_order_acquire)) == _tail)
+						return {};
+					break;
+				}
+			}
+			
+			const size_t slot = _tail & (h.capacity - 1);
+			return {records() + slot, std::min<size_t>(head - _tail, h.capacity - slot)};
+		}
+
+		/**
+		 * \brief Frees the first count records of the last acquisition for the producer
+		 */
+		void release(size_t count)
+		{
+			_tail += count;
+			header().tail.store(_tail, std::memory_order_release);
+		}
+
+		/**
+		 * \brief State of the producer
+		 */
+		shm_state_t state() const { return static_cast<shm_state_t>(header().state.load(std::memory_order_acquire)); }
+	};
+};//namespace tmm
+#endif //__TMM_SHM_H__
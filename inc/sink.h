@@ -0,0 +1,111 @@
+#ifndef __TMM_SINK_H__
+#define __TMM_SINK_H__
+
+/**
+ * \file sink.h
+ * \brief output sinks of sweeps
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Destination of the text written by sweeps
+	 * 
+	 * Writes arrive in output order from a single thread. A sink may return before the 
+	 * data reaches its destination, but must not keep a reference to it after write returns.
+	 */
+	class sink
+	{
+	public:
+		virtual ~sink() = default;
+
+		/**
+		 * \brief Appends size bytes at data
+		 */
+		virtual void write(const char* data, size_t size) = 0;
+
+		/**
+		 * \brief Waits for every write to reach the destination
+		 */
+		virtual void flush() { }
+	};
+
+	/**
+	 * \brief Sink writing to a file descriptor with write(2)
+	 */
+	class fd_sink : public sink
+	{
+		int _fd; ///< destination
+		bool _owned; ///< close _fd on destruction
+	public:
+		/**
+		 * \param fd open file descriptor
+		 * \param owned close fd on destruction
+		 */
+		explicit fd_sink(int fd, bool owned = false) : _fd(fd), _owned(owned) { }
+		~fd_sink() override
+		{
+			if (_owned)
+				close(_fd);
+		}
+
+		fd_sink(const fd_sink&) = delete;
+		fd_sink& operator=(const fd_sink&) = delete;
+
+		void write(const char* data, size_t size) override
+		{
+			while (size)
+			{
+				const ssize_t written = ::write(_fd, data, size);
+				if (written < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					throw std::runtime_error(std::string("write: ") + std::strerror(errno));
+				}
+				data += written;
+				size -= written;
+			}
+		}
+	};
+	struct ctl;
+
+	/**
+	 * \brief Opens the sink of a sweep
+	 * 
+	 * Writes to ctx.output, or to standard output when it is empty, with the writer of 
+	 * ctx.writer. When io_uring is unavailable the sink falls back to write(2) with a warning.
+	 */
+	std::unique_ptr<sink> open_sink(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_SINK_H__
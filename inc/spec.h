@@ -0,0 +1,105 @@
+#ifndef __TMM_SPEC_H__
+#define __TMM_SPEC_H__
+
+/**
+ * \file spec.h
+ * \brief spectral specification masks
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <vector>
+#include <algorithm>
+
+namespace tmm
+{
+	/**
+	 * \brief Spectral specification mask.
+	 * 
+	 * Per-wavelength bounds on R and T. Each list holds either one value per 
+	 * wavelength or a single value applied to every wavelength. Empty lists are unbounded.
+	 */
+	struct spec
+	{
+		std::vector<double> R_min; ///< lower bound on reflection
+		std::vector<double> R_max; ///< upper bound on reflection
+		std::vector<double> T_min; ///< lower bound on transmission
+		std::vector<double> T_max; ///< upper bound on transmission
+		std::vector<double> weight; ///< objective weight per wavelength, 0 masks the wavelength out
+
+		/**
+		 * \brief true if no bound is defined
+		 */
+		bool empty() const
+		{
+			return R_min.empty() && R_max.empty() && T_min.empty() && T_max.empty();
+		}
+
+		/**
+		 * \brief bound i of list v, broadcasting single values
+		 */
+		static double at(const std::vector<double>& v, size_t i, double fallback)
+		{
+			if (v.empty())
+				return fallback;
+			return v.size() == 1 ? v[0] : v[std::min(i, v.size() - 1)];
+		}
+
+		/**
+		 * \brief Squared violation of the mask at wavelength i
+		 * 
+		 * \param i wavelength index
+		 * \param R reflection coefficient
+		 * \param T transmission coefficient
+		 * \param dR optional sensitivity of the penalty to R
+		 * \param dT optional sensitivity of the penalty to T
+		 * \returns weighted penalty, 0 if the mask is met
+		 */
+		double penalty(size_t i, double R, double T, double* dR = nullptr, double* dT = nullptr) const
+		{
+			const double w = at(weight, i, 1.0);
+			
+			const double r = std::max(0.0, at(R_min, i, 0.0) - R);
+			const double R_ = std::max(0.0, R - at(R_max, i, 1.0));
+			const double t = std::max(0.0, at(T_min, i, 0.0) - T);
+			const double T_ = std::max(0.0, T - at(T_max, i, 1.0));
+			
+			if (dR) *dR = 2.0 * w * (R_ - r);
+			if (dT) *dT = 2.0 * w * (T_ - t);
+			
+			return w * (r * r + R_ * R_ + t * t + T_ * T_);
+		}
+
+		/**
+		 * \brief true if R and T satisfy the mask at wavelength i
+		 */
+		bool pass(size_t i, double R, double T) const
+		{
+			return at(weight, i, 1.0) == 0.0 
+				|| ( R >= at(R_min, i, 0.0) && R <= at(R_max, i, 1.0)
+					&& T >= at(T_min, i, 0.0) && T <= at(T_max, i, 1.0) );
+		}
+	};
+};//namespace tmm
+#endif //__TMM_SPEC_H__
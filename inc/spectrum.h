@@ -0,0 +1,70 @@
+#ifndef __TMM_SPECTRUM_H__
+#define __TMM_SPECTRUM_H__
+
+/**
+ * \file spectrum.h
+ * \brief measured spectrum import
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <vector>
+#include <string>
+
+namespace tmm
+{
+	/**
+	 * \brief Measured spectrum
+	 */
+	struct spectrum
+	{
+		std::vector<double> wavelength; ///< ascending wavelengths
+		std::vector<double> value; ///< measured R or T at each wavelength
+	};
+
+	/**
+	 * \brief Load measured spectra from a memory mapped file
+	 * 
+	 * Text files hold one "wavelength,value" pair per line, lines that do not start 
+	 * with a number (headers, comments) are skipped and a blank line separates spectra.
+	 * Binary files are a concatenation of records, each a uint64 sample count followed 
+	 * by that many (wavelength, value) float64 pairs in native byte order.
+	 * 
+	 * \param path file to load
+	 * \returns the spectra in file order, each sorted by wavelength
+	 */
+	std::vector<spectrum> load_spectra(const std::string& path);
+
+	/**
+	 * \brief Linear interpolation of a spectrum onto a grid
+	 * 
+	 * Grid points outside the measured range take the nearest end value.
+	 * 
+	 * \param s measured spectrum
+	 * \param grid target wavelengths
+	 * \returns values on the grid
+	 */
+	std::vector<double> resample(const spectrum& s, const std::vector<double>& grid);
+};//namespace tmm
+#endif //__TMM_SPECTRUM_H__
@@ -0,0 +1,50 @@
+#ifndef __TMM_SWEEP_H__
+#define __TMM_SWEEP_H__
+
+/**
+ * \file sweep.h
+ * \brief sweeps of the bragg device
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Sweep of the bragg device
+	 * 
+	 * Evaluates every design point of ctx at every wavelength by the plan of plan_sweep, 
+	 * writing one CSV row per point to standard output. Evaluation runs as a pipeline: 
+	 * blocks of design points are generated, evaluated by the planned kernel, formatted 
+	 * and written in order by separate stages connected by bounded queues, so that 
+	 * writing overlaps evaluation and memory stays bounded when the output is slow.
+	 * 
+	 * \param ctx control structure
+	 * \returns 0 on success
+	 */
+	int sweep(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_SWEEP_H__
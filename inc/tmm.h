@@ -39,6 +39,9 @@
 #include <cmath>
 #include <tuple>
 #include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
 namespace tmm
 {
@@ -47,6 +50,7 @@ namespace tmm
 	static constexpr double mu0 = 4 * pi * 1E-7; // Henries per meter (H/m)
 	static constexpr double c = 1/sqrt(eps0*mu0); // free space speed of light
 	static constexpr double eta0 = sqrt(mu0/eps0); // free space impedance
+	static constexpr double c_um_ps = 299.792458; // speed of light (um/ps), time-domain tasks take wavelengths in um
 
 	/**
 	 * \brief Transfer Matrix Method base class
@@ -118,7 +122,91 @@ namespace tmm
 			T[1][0] = b;
 			T[1][1] = a;
 		}
+
+		/**
+		 * \brief Adjoint of homogeneous_layer
+		 * 
+		 * Back-propagates the adjoint of a propagation matrix onto the layer parameters.
+		 * Adjoints follow the convention X_bar = dJ/dRe(X) + i*dJ/dIm(X) for a real objective J,
+		 * so that dJ/dp = Re(sum(conj(X_bar) * dX/dp)) for a real parameter p.
+		 * 
+		 * \param P_bar Adjoint of the propagation matrix
+		 * \param wavelength Wavelength in meters
+		 * \param length Layer length in meters
+		 * \param neff Effective refractive index
+		 * \param loss Loss in 1/m
+		 * \param length_bar Accumulated adjoint of the layer length
+		 * \param neff_bar Accumulated adjoint of the effective index
+		 * \param loss_bar Accumulated adjoint of the loss
+		 */
+		inline void 
+		homogeneous_layer_adjoint(std::complex<double>** P_bar, double wavelength, double length, double neff, double loss,
+			double& length_bar, double& neff_bar, double& loss_bar)
+		{
+			const std::complex<double> i(0, 1);
+			std::complex<double> b = beta(neff, wavelength, loss);
+			std::complex<double> phase = b * length;
+			
+			// dP00/dphase = i*P00, dP11/dphase = -i*P11
+			std::complex<double> g = std::conj(P_bar[0][0]) * i * std::exp(i * phase)
+				- std::conj(P_bar[1][1]) * i * std::exp(-i * phase);
+			
+			// phase = length * (k0*neff - i*loss/2)
+			const double k0 = 2.0 * pi / wavelength;
+			length_bar += std::real(g * b);
+			neff_bar += std::real(g) * k0 * length;
+			loss_bar += std::real(g * std::complex<double>(0, -length / 2.0));
+		}
+
+		/**
+		 * \brief Adjoint of index_step
+		 * 
+		 * \param T_bar Adjoint of the transfer matrix
+		 * \param n1 Refractive index of first medium
+		 * \param n2 Refractive index of second medium
+		 * \param n1_bar Accumulated adjoint of n1
+		 * \param n2_bar Accumulated adjoint of n2
+		 */
+		inline void 
+		index_step_adjoint(std::complex<double>** T_bar, double n1, double n2, double& n1_bar, double& n2_bar)
+		{
+			const double s = std::sqrt(n1 * n2);
+			const double s3 = 4.0 * s * s * s;
+			
+			// a and b are real, so only the real part of their adjoints contributes
+			const double a_bar = std::real(T_bar[0][0] + T_bar[1][1]);
+			const double b_bar = std::real(T_bar[0][1] + T_bar[1][0]);
+			
+			n1_bar += a_bar * n2 * (n1 - n2) / s3 + b_bar * n2 * (n1 + n2) / s3;
+			n2_bar += a_bar * n1 * (n2 - n1) / s3 - b_bar * n1 * (n1 + n2) / s3;
+		}
 	};
+
+	/**
+	 * \brief 2x2 product with the conjugate transpose of the left operand
+	 * 
+	 * C = A^H * B
+	 */
+	inline void 
+	multiply_hermitian_lhs(std::complex<double>** A, std::complex<double>** B, std::complex<double>** C)
+	{
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				C[i][j] = std::conj(A[0][i]) * B[0][j] + std::conj(A[1][i]) * B[1][j];
+	}
+
+	/**
+	 * \brief 2x2 product with the conjugate transpose of the right operand
+	 * 
+	 * C = A * B^H
+	 */
+	inline void 
+	multiply_hermitian_rhs(std::complex<double>** A, std::complex<double>** B, std::complex<double>** C)
+	{
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				C[i][j] = A[i][0] * std::conj(B[j][0]) + A[i][1] * std::conj(B[j][1]);
+	}
 	
 	/**
 	 * \brief Matrix power using binary exponentiation
@@ -185,6 +273,263 @@ namespace tmm
 				TN[i][j] = result[i][j];
 	}
 
+	/**
+	 * \brief Rescale a 2x2 matrix whose entries leave the representable range
+	 * 
+	 * \param A matrix, divided by its largest magnitude when that exceeds 1e100 or drops below 1e-100
+	 * \param log accumulated natural log of the scale removed from A
+	 */
+	inline void 
+	normalize(std::complex<double>** A, double& log)
+	{
+		double m = 0;
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				m = std::max(m, std::abs(A[i][j]));
+		
+		if (m > 1e100 || (m < 1e-100 && m > 0))
+		{
+			for (size_t i = 0; i < 2; ++i)
+				for (size_t j = 0; j < 2; ++j)
+					A[i][j] /= m;
+			log += std::log(m);
+		}
+	}
+
+	/**
+	 * \brief Matrix power using binary exponentiation, normalized
+	 * 
+	 * As matrix_power, but keeps the partial products representable so that powers 
+	 * deep inside a stopband do not overflow. T^N = TN * exp(returned value).
+	 * 
+	 * \param T input matrix
+	 * \param TN output matrix
+	 * \param N power
+	 * \returns natural log of the scale removed from TN
+	 */
+	inline double 
+	scaled_power(std::complex<double>** T, std::complex<double>** TN, uint64_t N)
+	{
+		auto base = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto temp = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				base[i][j] = T[i][j];
+		
+		damm::identity<std::complex<double>, damm::NONE>(TN, 2, 2);
+		double log = 0, base_log = 0;
+		
+		while (N)
+		{
+			if (N & 1)
+			{
+				damm::zeros<std::complex<double>, damm::NONE>(temp.get(), 2, 2);
+				damm::multiply<std::complex<double>, damm::NONE>(TN, base.get(), temp.get(), 2, 2, 2);
+				for (size_t i = 0; i < 2; ++i)
+					for (size_t j = 0; j < 2; ++j)
+						TN[i][j] = temp[i][j];
+				log += base_log;
+				normalize(TN, log);
+			}
+			
+			N >>= 1;
+			
+			if (N)
+			{
+				damm::zeros<std::complex<double>, damm::NONE>(temp.get(), 2, 2);
+				damm::multiply<std::complex<double>, damm::NONE>(base.get(), base.get(), temp.get(), 2, 2, 2);
+				for (size_t i = 0; i < 2; ++i)
+					for (size_t j = 0; j < 2; ++j)
+						base[i][j] = temp[i][j];
+				base_log *= 2;
+				normalize(base.get(), base_log);
+			}
+		}
+		return log;
+	}
+
+	/**
+	 * \brief Matrix power of a unimodular 2x2 matrix in closed form
+	 * 
+	 * For det T = 1 the Cayley-Hamilton theorem gives 
+	 * T^N = cos(NK) I + (T - cos(K) I) sin(NK) / sin(K) with cos(K) = tr(T) / 2, 
+	 * the Chebyshev form of the power, at a cost independent of N. The relative error 
+	 * grows as N eps / |sin K| towards the band edges, where matrix_power is used instead.
+	 * 
+	 * \param T input matrix, unimodular
+	 * \param TN output matrix
+	 * \param N power
+	 */
+	inline void 
+	chebyshev_power(std::complex<double>** T, std::complex<double>** TN, size_t N)
+	{
+		const std::complex<double> a = 0.5 * (T[0][0] + T[1][1]);
+		const std::complex<double> K = std::acos(a);
+		const std::complex<double> s = std::sin(K);
+		
+		if (std::abs(s) < 1e-7 * N)
+		{
+			matrix_power(T, TN, N);
+			return;
+		}
+		
+		const std::complex<double> NK = static_cast<double>(N) * K;
+		const std::complex<double> u = std::sin(NK) / s, v = std::cos(NK);
+		
+		TN[0][0] = v + (T[0][0] - a) * u;
+		TN[0][1] = T[0][1] * u;
+		TN[1][0] = T[1][0] * u;
+		TN[1][1] = v + (T[1][1] - a) * u;
+	}
+
+	/**
+	 * \brief Adjoint of matrix_power
+	 * 
+	 * Reverse-mode pass through the binary exponentiation of matrix_power. 
+	 * The O(log N) squarings and partial products are recomputed and taped,
+	 * then the adjoint of T^N is swept back through them.
+	 * 
+	 * \param T input matrix
+	 * \param TN_bar adjoint of T^N
+	 * \param T_bar output adjoint of T
+	 * \param N power
+	 */
+	inline void 
+	matrix_power_adjoint(std::complex<double>** T, std::complex<double>** TN_bar, std::complex<double>** T_bar, size_t N)
+	{
+		damm::zeros<std::complex<double>, damm::NONE>(T_bar, 2, 2);
+		
+		if (N == 0)
+			return;
+		
+		size_t levels = 0;
+		for (size_t n = N; n > 0; n >>= 1)
+			++levels;
+		
+		// Tape: base[j] = T^(2^j), partial[j] = product of the set bits below j
+		auto base = damm::aligned_alloc_2D<std::complex<double>, 64>(2 * levels, 2);
+		auto partial = damm::aligned_alloc_2D<std::complex<double>, 64>(2 * levels + 2, 2);
+		auto result_bar = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto base_bar = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto temp = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				base[i][j] = T[i][j];
+		
+		damm::identity<std::complex<double>, damm::NONE>(partial.get(), 2, 2);
+		
+		for (size_t l = 0; l < levels; ++l)
+		{
+			std::complex<double>** B = base.get() + 2 * l;
+			std::complex<double>** P = partial.get() + 2 * l;
+			std::complex<double>** Pn = partial.get() + 2 * (l + 1);
+			
+			if ((N >> l) & 1)
+			{
+				damm::zeros<std::complex<double>, damm::NONE>(Pn, 2, 2);
+				damm::multiply<std::complex<double>, damm::NONE>(P, B, Pn, 2, 2, 2);
+			}
+			else
+			{
+				for (size_t i = 0; i < 2; ++i)
+					for (size_t j = 0; j < 2; ++j)
+						Pn[i][j] = P[i][j];
+			}
+			
+			if (l + 1 < levels)
+			{
+				std::complex<double>** Bn = base.get() + 2 * (l + 1);
+				damm::zeros<std::complex<double>, damm::NONE>(Bn, 2, 2);
+				damm::multiply<std::complex<double>, damm::NONE>(B, B, Bn, 2, 2, 2);
+			}
+		}
+		
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+			{
+				result_bar[i][j] = TN_bar[i][j];
+				base_bar[i][j] = 0;
+			}
+		
+		// Sweep back from the highest bit
+		for (size_t l = levels; l-- > 0;)
+		{
+			std::complex<double>** B = base.get() + 2 * l;
+			std::complex<double>** P = partial.get() + 2 * l;
+			
+			if (l + 1 < levels)
+			{
+				// B(l+1) = B(l) * B(l)
+				multiply_hermitian_rhs(base_bar.get(), B, temp.get());
+				std::complex<double> acc[2][2];
+				for (size_t i = 0; i < 2; ++i)
+					for (size_t j = 0; j < 2; ++j)
+						acc[i][j] = temp[i][j];
+				
+				multiply_hermitian_lhs(B, base_bar.get(), temp.get());
+				for (size_t i = 0; i < 2; ++i)
+					for (size_t j = 0; j < 2; ++j)
+						base_bar[i][j] = acc[i][j] + temp[i][j];
+			}
+			
+			if ((N >> l) & 1)
+			{
+				// P(l+1) = P(l) * B(l)
+				multiply_hermitian_lhs(P, result_bar.get(), temp.get());
+				for (size_t i = 0; i < 2; ++i)
+					for (size_t j = 0; j < 2; ++j)
+						base_bar[i][j] += temp[i][j];
+				
+				multiply_hermitian_rhs(result_bar.get(), B, temp.get());
+				for (size_t i = 0; i < 2; ++i)
+					for (size_t j = 0; j < 2; ++j)
+						result_bar[i][j] = temp[i][j];
+			}
+		}
+		
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				T_bar[i][j] = base_bar[i][j];
+	}
+
+	/**
+	 * \brief Complex two-port scattering parameters
+	 */
+	struct sparameters
+	{
+		std::complex<double> S11; ///< reflection for incidence from port 1
+		std::complex<double> S21; ///< transmission from port 1 to port 2
+		std::complex<double> S12; ///< transmission from port 2 to port 1
+		std::complex<double> S22; ///< reflection for incidence from port 2
+	};
+
+	/**
+	 * \brief Extract both incidence directions from the total transfer matrix
+	 * 
+	 * With [a_0; b_0] = M [a_N; b_N]:
+	 * - S11 = M[1,0] / M[0,0], S21 = 1 / M[0,0]
+	 * - S22 = -M[0,1] / M[0,0], S12 = det(M) / M[0,0]
+	 * 
+	 * homogeneous_layer and index_step both have unit determinant, so det(M) = 1 for every
+	 * structure built from them and S12 = S21. The determinant is not formed numerically, 
+	 * inside a stopband it would cancel to rounding noise.
+	 * 
+	 * \param M 2x2 transfer matrix, possibly normalized
+	 * \param log natural log of the scale removed from M by normalize()
+	 * \returns the scattering parameters
+	 */
+	inline sparameters scattering_parameters(std::complex<double>** M, double log = 0)
+	{
+		sparameters S;
+		S.S11 = M[1][0] / M[0][0];
+		S.S21 = std::exp(-log) / M[0][0];
+		S.S12 = S.S21;
+		S.S22 = -M[0][1] / M[0][0];
+		return S;
+	}
+
 	/**
 	 * \brief Extract reflection and transmission from S-matrix
 	 * 
@@ -192,21 +537,58 @@ namespace tmm
 	 * - R = |S[1,0] / S[0,0]|^2 (reflection coefficient)
 	 * - T = |1 / S[0,0]|^2 (transmission coefficient)
 	 * 
+	 * The powers are squared magnitudes of the ratios, without square roots or pow; the 
+	 * ratios are formed first, so that they stay finite deep in a stopband where |S[0,0]|^2 
+	 * overflows. The phases, two atan2 calls, are skipped unless requested.
+	 * 
 	 * \param S 2x2 scattering matrix
 	 * \param R Output reflection coefficient
 	 * \param T Output transmission coefficient
-	 * \param r reflection phase
-	 * \param t transmission phase
+	 * \param r reflection phase, NaN when not requested
+	 * \param t transmission phase, NaN when not requested
+	 * \param phases compute r and t
 	 */
-	inline void scattering_coefficients(std::complex<double>** S, double& R, double& T, double& r, double& t)
+	inline void scattering_coefficients(std::complex<double>** S, double& R, double& T, double& r, double& t, 
+		bool phases = true)
 	{
-		std::complex<double> S00 = S[0][0];
-		std::complex<double> S10 = S[1][0];
+		const std::complex<double> rho = S[1][0] / S[0][0];
+		const std::complex<double> tau = 1.0 / S[0][0];
+		
+		R = std::norm(rho);
+		T = std::norm(tau);
 		
-		R = std::pow(std::abs(S10 / S00), 2.0);
-		T = std::pow(std::abs(1.0 / S00), 2.0);
-		r = std::arg(S10 / S00);
-		t = std::arg(1.0 / S00);
+		if (phases)
+		{
+			r = std::arg(rho);
+			t = std::arg(tau);
+		}
+		else
+			r = t = NAN;
+	}
+		
+	/**
+	 * \brief Adjoint of scattering_coefficients
+	 * 
+	 * Back-propagates the sensitivities of an objective to R and T onto the S-matrix.
+	 * 
+	 * \param S 2x2 scattering matrix
+	 * \param dR Sensitivity of the objective to R
+	 * \param dT Sensitivity of the objective to T
+	 * \param S_bar Output adjoint of S
+	 */
+	inline void scattering_adjoint(std::complex<double>** S, double dR, double dT, std::complex<double>** S_bar)
+	{
+		const std::complex<double> rho = S[1][0] / S[0][0];
+		const std::complex<double> tau = 1.0 / S[0][0];
+		const double R = std::norm(rho);
+		const double T = std::norm(tau);
+		
+		// d|z|^2 has adjoint 2z, and z / |S00|^2 = (z / S00) / conj(S00) stays finite
+		const std::complex<double> inverse = std::conj(tau);
+		S_bar[0][0] = -2.0 * (dR * R + dT * T) * inverse;
+		S_bar[0][1] = 0;
+		S_bar[1][0] = 2.0 * dR * rho * inverse;
+		S_bar[1][1] = 0;
 	}
 		
 	/**
@@ -256,6 +638,84 @@ namespace tmm
 		
 		return delay;
 	}
+
+	/**
+	 * \brief Best uniform wave-number grid through a list of wavelengths
+	 */
+	struct wavenumber_grid
+	{
+		double k0; ///< wave number of the first wavelength
+		double dk; ///< step between the end points
+		double deviation; ///< largest distance of a wave number from the uniform grid
+	};
+
+	/**
+	 * \brief Fits k = 2 pi / wavelength to a uniform grid through its end points
+	 * 
+	 * \param wavelengths at least two wavelengths
+	 */
+	inline wavenumber_grid uniform_wavenumber(const std::vector<double>& wavelengths)
+	{
+		const size_t K = wavelengths.size();
+		wavenumber_grid grid{2.0 * pi / wavelengths.front(), 0.0, 0.0};
+		grid.dk = (2.0 * pi / wavelengths.back() - grid.k0) / std::max<size_t>(K - 1, 1);
+		
+		for (size_t j = 0; j < K; ++j)
+			grid.deviation = std::max(grid.deviation, std::abs(2.0 * pi / wavelengths[j] - (grid.k0 + j * grid.dk)));
+		
+		return grid;
+	}
+
+	/**
+	 * \brief Propagation phase exp(i beta l) of a non-dispersive layer along a wave-number grid
+	 * 
+	 * On the uniform grid k0 + j dk the phase advances by the constant rotation 
+	 * exp(i dk n l), so the complex exponential of homogeneous_layer is replaced by one 
+	 * complex multiplication per point. The phase is re-evaluated exactly every `resync` 
+	 * points to bound the drift of the recurrence, and the small offset eps of the actual 
+	 * wave number from the grid is applied as exp(i eps) ~ 1 + i eps - eps^2/2.
+	 */
+	class phase_recurrence
+	{
+		static constexpr size_t resync = 64; ///< points between exact evaluations
+		
+		std::complex<double> _phase; ///< phase at the current grid point
+		std::complex<double> _step; ///< rotation between grid points
+		double _k0, _dk, _nl, _gain; ///< grid, n*l and the loss factor exponent
+		size_t _next = 0; ///< next grid point
+		
+		std::complex<double> exact(size_t j) const
+		{
+			return std::exp(std::complex<double>(_gain, (_k0 + j * _dk) * _nl));
+		}
+	public:
+		/**
+		 * \param grid uniform wave-number grid
+		 * \param neff effective index of the layer
+		 * \param length layer length
+		 * \param loss loss of the layer, as in homogeneous_layer
+		 */
+		phase_recurrence(const wavenumber_grid& grid, double neff, double length, double loss) : 
+		_step(std::polar(1.0, grid.dk * neff * length)), 
+		_k0(grid.k0), _dk(grid.dk), _nl(neff * length), _gain(loss / 2.0 * length) 
+		{ }
+
+		/**
+		 * \brief Phase at grid point j, called for j = 0, 1, 2, ... in order
+		 * \param k actual wave number of point j
+		 */
+		std::complex<double> operator()(size_t j, double k)
+		{
+			if (j != _next)
+				throw std::logic_error("phase_recurrence: grid points must be visited in order");
+			
+			_phase = j % resync ? _phase * _step : exact(j);
+			++_next;
+			
+			const double eps = (k - (_k0 + j * _dk)) * _nl;
+			return _phase * std::complex<double>(1.0 - 0.5 * eps * eps, eps);
+		}
+	};
 	
 } // namespace tmm
 
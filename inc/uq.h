@@ -0,0 +1,49 @@
+#ifndef __TMM_UQ_H__
+#define __TMM_UQ_H__
+
+/**
+ * \file uq.h
+ * \brief polynomial chaos uncertainty quantification
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <ctl.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Polynomial chaos uncertainty quantification
+	 * 
+	 * Evaluates the nominal design perturbed by ctx.variations at the nodes of a Smolyak 
+	 * sparse grid of Gauss-Hermite (normal) and Gauss-Legendre (uniform) rules, in parallel, 
+	 * and fits a total degree ctx.order polynomial chaos expansion of R and T per wavelength 
+	 * by least squares. Means, standard deviations and Sobol indices follow from the 
+	 * coefficients, quantiles from sampling the expansion.
+	 * 
+	 * \returns 0 on success
+	 */
+	int uq(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_UQ_H__
@@ -0,0 +1,112 @@
+#ifndef __TMM_URING_H__
+#define __TMM_URING_H__
+
+/**
+ * \file uring.h
+ * \brief io_uring output sink
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <sink.h>
+#include <memory>
+#include <vector>
+#include <cstdlib>
+#include <sys/types.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace tmm
+{
+	/**
+	 * \brief Sink submitting large aligned buffers through io_uring
+	 * 
+	 * Text is gathered into a pool of page-aligned buffers. Full buffers are submitted 
+	 * as asynchronous writes, up to one per buffer in flight, and recycled once their 
+	 * completions are reaped, so that write returns as soon as the data is copied and 
+	 * the sweep continues while the kernel writes. Seekable files are written at 
+	 * explicit offsets; pipes and sockets keep one write in flight to preserve order.
+	 * With O_DIRECT every write but the last is whole aligned buffers, and the unaligned 
+	 * tail is written by flush with O_DIRECT cleared.
+	 * 
+	 * The ring is driven by the raw io_uring_setup and io_uring_enter system calls, and 
+	 * construction throws when io_uring or its write operation is unavailable.
+	 */
+	class uring_sink : public sink
+	{
+		/**
+		 * \brief Buffer of the pool
+		 */
+		struct buffer
+		{
+			std::unique_ptr<char, decltype(&std::free)> data{nullptr, &std::free}; ///< page-aligned storage
+			size_t size = 0; ///< bytes filled
+			size_t done = 0; ///< bytes written of a submitted buffer
+			off_t offset = 0; ///< file offset of a submitted buffer
+		};
+		
+		int _fd; ///< destination
+		bool _owned; ///< close _fd on destruction
+		bool _direct; ///< _fd is open with O_DIRECT
+		bool _seekable; ///< _fd takes explicit offsets
+		off_t _offset = 0; ///< file offset of the next submitted buffer
+		size_t _capacity; ///< bytes per buffer
+		
+		int _ring = -1; ///< io_uring file descriptor
+		void* _sq_map = nullptr; ///< submission ring mapping
+		void* _cq_map = nullptr; ///< completion ring mapping, may alias _sq_map
+		size_t _sq_size = 0, _cq_size = 0, _sqes_size = 0; ///< mapping sizes
+		unsigned *_sq_tail, *_sq_mask, *_sq_array; ///< submission ring fields
+		unsigned *_cq_head, *_cq_tail, *_cq_mask; ///< completion ring fields
+		io_uring_sqe* _sqes = nullptr; ///< submission entries
+		io_uring_cqe* _cqes; ///< completion entries
+		
+		std::vector<buffer> _buffers; ///< the pool
+		std::vector<size_t> _free; ///< buffers neither filling nor in flight
+		size_t _current; ///< buffer being filled, _buffers.size() for none
+		size_t _in_flight = 0; ///< buffers submitted and not completed
+
+		void enqueue(size_t i); ///< submits the unwritten part of buffer i
+		void submit(size_t i); ///< assigns buffer i its offset and submits it
+		void reap(bool wait); ///< processes completions, waiting for one if wait
+		void drain(); ///< waits for every buffer in flight
+	public:
+		/**
+		 * \param fd open file descriptor
+		 * \param owned close fd on destruction
+		 * \param capacity bytes per buffer, a multiple of 4096
+		 * \param depth buffers in the pool, the most writes in flight
+		 */
+		uring_sink(int fd, bool owned, size_t capacity = size_t(1) << 20, size_t depth = 8);
+		~uring_sink() override;
+
+		uring_sink(const uring_sink&) = delete;
+		uring_sink& operator=(const uring_sink&) = delete;
+
+		void write(const char* data, size_t size) override;
+		void flush() override;
+	};
+};//namespace tmm
+#endif //__TMM_URING_H__
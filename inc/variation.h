@@ -0,0 +1,130 @@
+#ifndef __TMM_VARIATION_H__
+#define __TMM_VARIATION_H__
+
+/**
+ * \file variation.h
+ * \brief process variation models
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace tmm
+{
+	/**
+	 * \brief Design variable subject to process variation
+	 */
+	enum variable_t: uint8_t
+	{
+		VAR_PERIOD, ///< grating period
+		VAR_DUTY_CYCLE, ///< dutycycle
+		VAR_W1, ///< width of the high index region
+		VAR_W2, ///< width of the low index region
+		VAR_N1, ///< offset of n1
+		VAR_N2, ///< offset of n2
+		VAR_LOSS, ///< offset of the loss
+		VAR_SIZE
+	};
+
+	/**
+	 * \brief Distribution of a variable about its nominal value
+	 */
+	enum distribution_t: uint8_t
+	{
+		NORMAL, ///< offset ~ N(0, a^2)
+		UNIFORM, ///< offset ~ U(a, b)
+	};
+
+	static constexpr const char* variable_names[VAR_SIZE] = {"period", "dutycycle", "w1", "w2", "n1", "n2", "loss"};
+
+	/**
+	 * \brief Random offset applied to a design variable
+	 */
+	struct variation
+	{
+		variable_t variable; ///< the perturbed variable
+		distribution_t distribution; ///< offset distribution
+		double a; ///< standard deviation (normal) or lower offset (uniform)
+		double b; ///< upper offset (uniform)
+
+		/**
+		 * \brief Offset for a standard normal or unit uniform draw
+		 */
+		double operator()(double normal, double uniform) const
+		{
+			return distribution == NORMAL ? a * normal : a + (b - a) * uniform;
+		}
+	};
+
+	/**
+	 * \brief Parse a variation <variable>:normal:<sigma> or <variable>:uniform:<lo>:<hi>
+	 */
+	inline variation 
+	parse_variation(const std::string& str)
+	{
+		std::vector<std::string> fields;
+		size_t start = 0;
+		while (start <= str.size())
+		{
+			size_t end = str.find(':', start);
+			if (end == std::string::npos)
+				end = str.size();
+			fields.push_back(str.substr(start, end - start));
+			start = end + 1;
+		}
+		
+		if (fields.size() < 3)
+			throw std::runtime_error(str + " expected <variable>:<distribution>:<parameters>");
+		
+		variation v{};
+		
+		size_t i = 0;
+		while (i < VAR_SIZE && fields[0] != variable_names[i])
+			++i;
+		if (i == VAR_SIZE)
+			throw std::runtime_error("unknown variable '" + fields[0] + "'");
+		v.variable = static_cast<variable_t>(i);
+		
+		if (fields[1] == "normal" && fields.size() == 3)
+		{
+			v.distribution = NORMAL;
+			v.a = std::stod(fields[2]);
+		}
+		else if (fields[1] == "uniform" && fields.size() == 4)
+		{
+			v.distribution = UNIFORM;
+			v.a = std::stod(fields[2]);
+			v.b = std::stod(fields[3]);
+		}
+		else
+			throw std::runtime_error(str + " expected normal:<sigma> or uniform:<lo>:<hi>");
+		
+		return v;
+	}
+};//namespace tmm
+#endif //__TMM_VARIATION_H__
@@ -0,0 +1,94 @@
+#ifndef __TMM_VECTFIT_H__
+#define __TMM_VECTFIT_H__
+
+/**
+ * \file vectfit.h
+ * \brief vector fitting of rational device models
+ * \author cpapakonstantinou
+ * \date 2026
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <array>
+#include <vector>
+#include <complex>
+#include <ctl.h>
+
+namespace tmm
+{
+	/**
+	 * \brief Pole-residue model of the S11, S21 and S22 responses of a device
+	 * 
+	 * S_j(s) = d_j + sum_m residues[j][m] / (s - poles[m]), the poles shared by all three.
+	 */
+	struct rational_model
+	{
+		std::vector<std::complex<double>> poles; ///< common poles, Re < 0
+		std::array<std::vector<std::complex<double>>, 3> residues; ///< residues of S11, S21, S22
+		std::array<std::complex<double>, 3> d; ///< constant terms of S11, S21, S22
+		double rms = 0; ///< rms error over the fitted samples
+		double scale = 1; ///< passivity scale applied to the residues and constants
+		size_t iterations = 0; ///< pole relocation iterations
+	};
+
+	/**
+	 * \brief Relaxed vector fitting with common poles
+	 * 
+	 * Gustavsen and Semlyen, "Rational approximation of frequency domain responses by 
+	 * vector fitting", IEEE Trans. Power Delivery 14 (1999), with the relaxed scaling 
+	 * function of Gustavsen (2006) and the per-response QR of fast vector fitting. The 
+	 * responses are complex baseband signals, so poles are not constrained to conjugate 
+	 * pairs; unstable poles are reflected into the left half plane every iteration.
+	 * 
+	 * \param s sample points on the imaginary axis
+	 * \param f samples of S11, S21 and S22
+	 * \param order number of poles
+	 * \param iterations limit of pole relocation iterations
+	 * \returns the model, passivity not yet enforced
+	 */
+	rational_model vector_fit(const std::vector<std::complex<double>>& s, 
+		const std::array<std::vector<std::complex<double>>, 3>& f, size_t order, size_t iterations);
+
+	/**
+	 * \brief Enforces passivity of a fitted two-port by uniform scaling
+	 * 
+	 * The largest singular value of [[S11, S21], [S21, S22]] is checked on a grid denser 
+	 * than the samples between lo and hi; if it exceeds 1, the residues and constants are 
+	 * divided by it.
+	 * 
+	 * \param model fitted model, rescaled in place
+	 * \param lo lower end of the band on the imaginary axis
+	 * \param hi upper end of the band on the imaginary axis
+	 * \param points number of check points
+	 */
+	void enforce_passivity(rational_model& model, double lo, double hi, size_t points);
+
+	/**
+	 * \brief Pole-residue models of every design of a sweep
+	 * 
+	 * \param ctx control structure
+	 * \returns 0 on success
+	 */
+	int vectfit(const ctl& ctx);
+};//namespace tmm
+#endif //__TMM_VECTFIT_H__
@@ -67,6 +67,20 @@ namespace tmm
 		damm::multiply<std::complex<double>, damm::NONE>(T_11.get(), T_21.get(), Tp, 2, 2, 2);
 	}
 
+	void 
+	Bragg::transfer_matrix(std::complex<double>** Tp, std::complex<double> p1, std::complex<double> p2, double n1, double n2)
+	{
+		// Tp = diag(p1, 1/p1) [[a, b], [b, a]] diag(p2, 1/p2) [[a, -b], [-b, a]], expanded
+		const double a = (n1 + n2) / (2.0 * std::sqrt(n1 * n2));
+		const double b = (n1 - n2) / (2.0 * std::sqrt(n1 * n2));
+		const std::complex<double> q1 = 1.0 / p1, q2 = 1.0 / p2;
+		
+		Tp[0][0] = p1 * (a * a * p2 - b * b * q2);
+		Tp[0][1] = p1 * a * b * (q2 - p2);
+		Tp[1][0] = q1 * a * b * (p2 - q2);
+		Tp[1][1] = q1 * (a * a * q2 - b * b * p2);
+	}
+
 	void 
 	Bragg::scattering_matrix(std::complex<double>** T, double wavelength, double n1, double n2, double loss)
 	{
@@ -77,7 +91,7 @@ namespace tmm
 	}
 
 	std::tuple<double, double, double, double>
-	Bragg::scattering_coefficients(double wavelength, double n1, double n2, double loss)
+	Bragg::scattering_coefficients(double wavelength, double n1, double n2, double loss, bool phases)
 	{
 		auto sparams = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
 		
@@ -85,10 +99,103 @@ namespace tmm
 
 		double R, T, r, t;
 
-		tmm::scattering_coefficients(sparams.get(), R, T, r, t);
+		tmm::scattering_coefficients(sparams.get(), R, T, r, t, phases);
+
+		return std::make_tuple(R, T, r, t);
+	}
+
+	std::tuple<double, double, double, double>
+	Bragg::scattering_coefficients(std::complex<double> p1, std::complex<double> p2, double n1, double n2, bool phases)
+	{
+		auto Tp = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto sparams = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		
+		transfer_matrix(Tp.get(), p1, p2, n1, n2);
+		matrix_power(Tp.get(), sparams.get(), _N);
+
+		double R, T, r, t;
+
+		tmm::scattering_coefficients(sparams.get(), R, T, r, t, phases);
 
 		return std::make_tuple(R, T, r, t);
 	}
 
+	sparameters
+	Bragg::scattering_parameters(double wavelength, double n1, double n2, double loss)
+	{
+		auto M = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		
+		scattering_matrix(M.get(), wavelength, n1, n2, loss);
+
+		return tmm::scattering_parameters(M.get());
+	}
+
+	void 
+	Bragg::transfer_matrix_adjoint(std::complex<double>** Tp_bar, double wavelength, double n1, double n2, double loss, bragg_gradient& grad)
+	{
+		double l1 = _period * _duty_cycle;
+		double l2 = _period * (1.0 - _duty_cycle);
+		
+		auto T_11 = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto T_12 = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto T_22 = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto T_21 = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto head = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto tail = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto work = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto bar = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		
+		homogeneous_layer(T_11.get(), wavelength, l1, n1, loss);
+		index_step(T_12.get(), n1, n2);
+		homogeneous_layer(T_22.get(), wavelength, l2, n2, loss);
+		index_step(T_21.get(), n2, n1);
+		
+		double l1_bar = 0, l2_bar = 0;
+		
+		// Tp = T_11 * T_12 * T_22 * T_21, adjoint of each factor is head^H * Tp_bar * tail^H
+		
+		// tail = T_12 * T_22 * T_21
+		damm::zeros<std::complex<double>, damm::NONE>(work.get(), 2, 2);
+		damm::multiply<std::complex<double>, damm::NONE>(T_22.get(), T_21.get(), work.get(), 2, 2, 2);
+		damm::zeros<std::complex<double>, damm::NONE>(tail.get(), 2, 2);
+		damm::multiply<std::complex<double>, damm::NONE>(T_12.get(), work.get(), tail.get(), 2, 2, 2);
+		
+		multiply_hermitian_rhs(Tp_bar, tail.get(), bar.get());
+		homogeneous_layer_adjoint(bar.get(), wavelength, l1, n1, loss, l1_bar, grad.n1, grad.loss);
+		
+		// head = T_11, tail = T_22 * T_21
+		multiply_hermitian_lhs(T_11.get(), Tp_bar, head.get());
+		multiply_hermitian_rhs(head.get(), work.get(), bar.get());
+		index_step_adjoint(bar.get(), n1, n2, grad.n1, grad.n2);
+		
+		// head = T_11 * T_12, tail = T_21
+		damm::zeros<std::complex<double>, damm::NONE>(head.get(), 2, 2);
+		damm::multiply<std::complex<double>, damm::NONE>(T_11.get(), T_12.get(), head.get(), 2, 2, 2);
+		multiply_hermitian_lhs(head.get(), Tp_bar, work.get());
+		multiply_hermitian_rhs(work.get(), T_21.get(), bar.get());
+		homogeneous_layer_adjoint(bar.get(), wavelength, l2, n2, loss, l2_bar, grad.n2, grad.loss);
+		
+		// head = T_11 * T_12 * T_22
+		damm::zeros<std::complex<double>, damm::NONE>(work.get(), 2, 2);
+		damm::multiply<std::complex<double>, damm::NONE>(head.get(), T_22.get(), work.get(), 2, 2, 2);
+		multiply_hermitian_lhs(work.get(), Tp_bar, bar.get());
+		index_step_adjoint(bar.get(), n2, n1, grad.n2, grad.n1);
+		
+		// l1 = period * duty_cycle, l2 = period * (1 - duty_cycle)
+		grad.period += l1_bar * _duty_cycle + l2_bar * (1.0 - _duty_cycle);
+		grad.duty_cycle += (l1_bar - l2_bar) * _period;
+	}
+
+	void 
+	Bragg::scattering_matrix_adjoint(std::complex<double>** T_bar, double wavelength, double n1, double n2, double loss, bragg_gradient& grad)
+	{
+		auto Tp = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto Tp_bar = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		
+		transfer_matrix(Tp.get(), wavelength, n1, n2, loss);
+		matrix_power_adjoint(Tp.get(), T_bar, Tp_bar.get(), _N);
+		transfer_matrix_adjoint(Tp_bar.get(), wavelength, n1, n2, loss, grad);
+	}
+
 
 }//namespace tmm
\ No newline at end of file
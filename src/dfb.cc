@@ -0,0 +1,267 @@
+/**
+ * \file dfb.cc
+ * \brief implementations for dfb.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <dfb.h>
+#include <bragg.h>
+#include <pool.h>
+#include <iostream>
+#include <algorithm>
+#include <numbers>
+
+namespace tmm
+{
+	namespace
+	{
+		constexpr size_t block = 256; ///< designs solved in parallel between writes
+		constexpr size_t edge_samples = 16; ///< initial samples per rectangle edge
+		constexpr size_t max_depth = 12; ///< subdivision levels of the window
+
+		/**
+		 * \brief M00 of the total transfer matrix at a wavelength and gain, normalized
+		 * 
+		 * \param log natural log of the scale removed from the returned value
+		 */
+		std::complex<double> 
+		m00(const ctl& ctx, const design& d, double wavelength, double gain, double& log)
+		{
+			auto Tp = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			auto TN = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			
+			Bragg grating(d.period, d.duty_cycle, d.N);
+			grating.transfer_matrix(Tp.get(), wavelength, 
+				(*ctx.n1)(wavelength, d.w1), 
+				(*ctx.n2)(wavelength, d.w2), 
+				(*ctx.loss)(wavelength, 0.0) - gain);
+			
+			log = scaled_power(Tp.get(), TN.get(), static_cast<uint64_t>(d.N));
+			return TN[0][0];
+		}
+
+		/**
+		 * \brief Winding number of M00 along the boundary of a rectangle
+		 * 
+		 * Edges are sampled until the phase changes by less than pi/4 between neighbours.
+		 */
+		int 
+		winding(const ctl& ctx, const design& d, double l0, double l1, double g0, double g1)
+		{
+			const std::array<std::array<double, 2>, 5> corners{{{l0, g0}, {l1, g0}, {l1, g1}, {l0, g1}, {l0, g0}}};
+			double total = 0;
+			
+			for (size_t e = 0; e < 4; ++e)
+			{
+				const auto& a = corners[e];
+				const auto& b = corners[e + 1];
+				
+				auto phase = [&](double s)
+				{
+					double log;
+					return std::arg(m00(ctx, d, a[0] + s * (b[0] - a[0]), a[1] + s * (b[1] - a[1]), log));
+				};
+				
+				// Adaptive bisection of the edge, stack of (s0, s1, phase0, phase1, depth)
+				struct span { double s0, s1, p0, p1; size_t depth; };
+				std::vector<span> stack;
+				
+				double previous = phase(0.0);
+				for (size_t k = 1; k <= edge_samples; ++k)
+				{
+					const double s = static_cast<double>(k) / edge_samples;
+					const double p = phase(s);
+					stack.push_back({s - 1.0 / edge_samples, s, previous, p, 0});
+					previous = p;
+				}
+				
+				// Spans are taken in order along the edge
+				std::reverse(stack.begin(), stack.end());
+				while (!stack.empty())
+				{
+					span sp = stack.back();
+					stack.pop_back();
+					
+					double delta = std::remainder(sp.p1 - sp.p0, 2 * std::numbers::pi);
+					if (std::abs(delta) > std::numbers::pi / 4 && sp.depth < 20)
+					{
+						const double sm = 0.5 * (sp.s0 + sp.s1);
+						const double pm = phase(sm);
+						stack.push_back({sm, sp.s1, pm, sp.p1, sp.depth + 1});
+						stack.push_back({sp.s0, sm, sp.p0, pm, sp.depth + 1});
+						continue;
+					}
+					total += delta;
+				}
+			}
+			
+			return static_cast<int>(std::lround(total / (2 * std::numbers::pi)));
+		}
+
+		/**
+		 * \brief Newton polish of a zero of M00 from a starting point
+		 * \returns true if converged inside the bounds
+		 */
+		bool 
+		newton(const ctl& ctx, const design& d, double& l, double& g, 
+			double l0, double l1, double g0, double g1)
+		{
+			const double hl = 1e-7 * (l1 - l0);
+			const double hg = 1e-7 * (g1 - g0);
+			
+			for (size_t it = 0; it < 50; ++it)
+			{
+				// Values relative to the scale at the current point
+				double log;
+				const std::complex<double> f = m00(ctx, d, l, g, log);
+				auto at = [&](double l_, double g_) 
+				{ 
+					double lg;
+					auto v = m00(ctx, d, l_, g_, lg);
+					return v * std::exp(lg - log);
+				};
+				
+				const std::complex<double> fl = (at(l + hl, g) - at(l - hl, g)) / (2 * hl);
+				const std::complex<double> fg = (at(l, g + hg) - at(l, g - hg)) / (2 * hg);
+				
+				// Real 2x2 Newton step on (Re f, Im f)
+				const double det = fl.real() * fg.imag() - fg.real() * fl.imag();
+				if (det == 0)
+					return false;
+				
+				const double dl = (f.real() * fg.imag() - fg.real() * f.imag()) / det;
+				const double dg = (fl.real() * f.imag() - f.real() * fl.imag()) / det;
+				
+				l -= dl;
+				g -= dg;
+				
+				if (l < l0 || l > l1 || g < g0 || g > g1)
+					return false;
+				
+				if (std::abs(dl) < 1e-12 * (l1 - l0) && std::abs(dg) < 1e-12 * (g1 - g0))
+					return true;
+			}
+			return false;
+		}
+	}
+
+	std::vector<lasing_mode> 
+	lasing_modes(const ctl& ctx, const design& d, std::array<double, 2> wavelength, std::array<double, 2> gain)
+	{
+		struct rectangle { double l0, l1, g0, g1; size_t depth; };
+		
+		std::vector<lasing_mode> modes;
+		std::vector<rectangle> stack{{wavelength[0], wavelength[1], gain[0], gain[1], 0}};
+		
+		while (!stack.empty())
+		{
+			auto r = stack.back();
+			stack.pop_back();
+			
+			const int n = winding(ctx, d, r.l0, r.l1, r.g0, r.g1);
+			if (n == 0)
+				continue;
+			
+			// A single zero in a small enough rectangle is handed to Newton from the centre
+			if (std::abs(n) == 1 && r.depth >= 2)
+			{
+				double l = 0.5 * (r.l0 + r.l1), g = 0.5 * (r.g0 + r.g1);
+				if (newton(ctx, d, l, g, r.l0, r.l1, r.g0, r.g1))
+				{
+					modes.push_back({l, g});
+					continue;
+				}
+			}
+			
+			if (r.depth == max_depth)
+			{
+				modes.push_back({0.5 * (r.l0 + r.l1), 0.5 * (r.g0 + r.g1)});
+				continue;
+			}
+			
+			const double lm = 0.5 * (r.l0 + r.l1), gm = 0.5 * (r.g0 + r.g1);
+			stack.push_back({r.l0, lm, r.g0, gm, r.depth + 1});
+			stack.push_back({lm, r.l1, r.g0, gm, r.depth + 1});
+			stack.push_back({r.l0, lm, gm, r.g1, r.depth + 1});
+			stack.push_back({lm, r.l1, gm, r.g1, r.depth + 1});
+		}
+		
+		std::sort(modes.begin(), modes.end(), [](const auto& a, const auto& b) { return a.gain < b.gain; });
+		return modes;
+	}
+
+	int 
+	dfb(const ctl& ctx)
+	{
+		const auto points = designs(ctx);
+		const auto [lmin, lmax] = std::minmax_element(ctx.wavelengths.begin(), ctx.wavelengths.end());
+		const std::array<double, 2> wavelength{*lmin, *lmax};
+		const std::array<double, 2> gain{ctx.gain.size() > 1 ? ctx.gain[0] : 0.0, ctx.gain.back()};
+		
+		bool sweep_width1 = !ctx.width1.empty();
+		bool sweep_width2 = !ctx.width2.empty();
+		
+		printf("period,duty_cycle,N");
+		if (sweep_width1) printf(",w1");
+		if (sweep_width2) printf(",w2");
+		printf(",modes,threshold_gain,lasing_wavelength,gain_margin,second_wavelength\n");
+		
+		std::vector<std::vector<lasing_mode>> modes(block);
+		
+		for (size_t begin = 0; begin < points.size(); begin += block)
+		{
+			const size_t end = std::min(begin + block, points.size());
+			
+			parallel_for(end - begin, [&](size_t j, size_t)
+			{
+				modes[j] = lasing_modes(ctx, points[begin + j], wavelength, gain);
+			}, ctx.threads);
+			
+			for (size_t j = 0; j < end - begin; ++j)
+			{
+				const auto& d = points[begin + j];
+				const auto& m = modes[j];
+				
+				printf("%.6g,%.6g,%.6g", d.period, d.duty_cycle, d.N);
+				if (sweep_width1) printf(",%.6g", d.w1);
+				if (sweep_width2) printf(",%.6g", d.w2);
+				printf(",%zu", m.size());
+				
+				if (m.empty())
+					printf(",nan,nan");
+				else
+					printf(",%.8g,%.8g", m[0].gain, m[0].wavelength);
+				
+				if (m.size() < 2)
+					printf(",nan,nan\n");
+				else
+					printf(",%.6g,%.8g\n", m[1].gain - m[0].gain, m[1].wavelength);
+			}
+		}
+		
+		return 0;
+	}
+}//namespace tmm
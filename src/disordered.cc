@@ -0,0 +1,203 @@
+/**
+ * \file disordered.cc
+ * \brief implementations for disordered.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <disordered.h>
+#include <rng.h>
+#include <pool.h>
+#include <algorithm>
+
+namespace tmm
+{
+	namespace
+	{
+		/**
+		 * \brief Exponentially correlated Gaussian sequence
+		 */
+		std::vector<double> 
+		correlated_noise(const philox& rng, size_t n, double sigma, double rho, uint64_t stream)
+		{
+			std::vector<double> x(n, 0.0);
+			
+			if (sigma == 0.0)
+				return x;
+			
+			const double innovation = std::sqrt(1.0 - rho * rho);
+			
+			for (size_t k = 0; k < n; ++k)
+			{
+				double xi = sigma * rng.normal(k, stream);
+				x[k] = k ? rho * x[k - 1] + innovation * xi : xi;
+			}
+			
+			return x;
+		}
+
+		static constexpr size_t min_chunk = 1024; ///< periods per product chunk before threading pays off
+	}
+
+	Disordered::Disordered(double period, double duty_cycle, double N, const disorder& stats, uint64_t seed, size_t realization) :
+	_period(period)
+	{
+		const size_t n = static_cast<size_t>(N);
+		const double rho = stats.correlation_length > 0 ? std::exp(-period / stats.correlation_length) : 0.0;
+		const philox rng(seed);
+		
+		_duty_cycle = correlated_noise(rng, n, stats.duty_cycle, rho, 3 * realization);
+		_dw1 = correlated_noise(rng, n, stats.width, rho, 3 * realization + 1);
+		_dw2 = correlated_noise(rng, n, stats.width, rho, 3 * realization + 2);
+		
+		for (auto& d : _duty_cycle)
+			d = std::clamp(duty_cycle + d, 0.0, 1.0);
+	}
+
+	double 
+	Disordered::product(std::complex<double>** T, double wavelength, const cml& n1, const cml& n2, 
+		double w1, double w2, double loss, size_t idx, size_t threads)
+	{
+		const size_t N = _duty_cycle.size();
+		
+		// No periods, the grating is the identity as in Bragg
+		if (N == 0)
+		{
+			damm::identity<std::complex<double>, damm::NONE>(T, 2, 2);
+			return 0;
+		}
+		
+		const size_t chunks = std::max<size_t>(1, std::min(concurrency(threads) * 4, N / min_chunk));
+		
+		auto partial = damm::aligned_alloc_2D<std::complex<double>, 64>(2 * chunks, 2);
+		std::vector<double> log_scale(chunks, 0.0);
+		
+		// Each chunk multiplies a contiguous run of periods, chunk products are combined in order
+		parallel_for(chunks, [&](size_t c, size_t)
+		{
+			auto P_1 = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			auto T_12 = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			auto P_2 = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			auto T_21 = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			auto work = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			auto Tp = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			
+			std::complex<double>** acc = partial.get() + 2 * c;
+			damm::identity<std::complex<double>, damm::NONE>(acc, 2, 2);
+			
+			const size_t begin = c * N / chunks;
+			const size_t end = (c + 1) * N / chunks;
+			
+			double n1_k = n1(wavelength, w1 + _dw1[begin], idx);
+			
+			for (size_t k = begin; k < end; ++k)
+			{
+				const double n2_k = n2(wavelength, w2 + _dw2[k], idx);
+				
+				// The period ends on the index of the next period, or the nominal index at the output
+				const double n1_next = n1(wavelength, w1 + (k + 1 < N ? _dw1[k + 1] : 0.0), idx);
+				
+				homogeneous_layer(P_1.get(), wavelength, _period * _duty_cycle[k], n1_k, loss);
+				index_step(T_12.get(), n1_k, n2_k);
+				homogeneous_layer(P_2.get(), wavelength, _period * (1.0 - _duty_cycle[k]), n2_k, loss);
+				index_step(T_21.get(), n2_k, n1_next);
+				
+				// Tp = P_1 * T_12 * P_2 * T_21
+				damm::zeros<std::complex<double>, damm::NONE>(work.get(), 2, 2);
+				damm::multiply<std::complex<double>, damm::NONE>(P_1.get(), T_12.get(), work.get(), 2, 2, 2);
+				damm::zeros<std::complex<double>, damm::NONE>(P_1.get(), 2, 2);
+				damm::multiply<std::complex<double>, damm::NONE>(work.get(), P_2.get(), P_1.get(), 2, 2, 2);
+				damm::zeros<std::complex<double>, damm::NONE>(Tp.get(), 2, 2);
+				damm::multiply<std::complex<double>, damm::NONE>(P_1.get(), T_21.get(), Tp.get(), 2, 2, 2);
+				
+				// acc = acc * Tp
+				damm::zeros<std::complex<double>, damm::NONE>(work.get(), 2, 2);
+				damm::multiply<std::complex<double>, damm::NONE>(acc, Tp.get(), work.get(), 2, 2, 2);
+				for (size_t i = 0; i < 2; ++i)
+					for (size_t j = 0; j < 2; ++j)
+						acc[i][j] = work[i][j];
+				
+				normalize(acc, log_scale[c]);
+				
+				n1_k = n1_next;
+			}
+		}, chunks > 1 ? threads : 1);
+		
+		// Pairwise tree over the chunk products
+		for (size_t stride = 1; stride < chunks; stride *= 2)
+		{
+			auto work = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			
+			for (size_t c = 0; c + stride < chunks; c += 2 * stride)
+			{
+				std::complex<double>** left = partial.get() + 2 * c;
+				std::complex<double>** right = partial.get() + 2 * (c + stride);
+				
+				damm::zeros<std::complex<double>, damm::NONE>(work.get(), 2, 2);
+				damm::multiply<std::complex<double>, damm::NONE>(left, right, work.get(), 2, 2, 2);
+				for (size_t i = 0; i < 2; ++i)
+					for (size_t j = 0; j < 2; ++j)
+						left[i][j] = work[i][j];
+				
+				log_scale[c] += log_scale[c + stride];
+				normalize(left, log_scale[c]);
+			}
+		}
+		
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				T[i][j] = partial[i][j];
+		
+		return log_scale[0];
+	}
+
+	void 
+	Disordered::scattering_matrix(std::complex<double>** T, double wavelength, const cml& n1, const cml& n2, 
+		double w1, double w2, double loss, size_t idx, size_t threads)
+	{
+		const double scale = std::exp(product(T, wavelength, n1, n2, w1, w2, loss, idx, threads));
+		
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				T[i][j] *= scale;
+	}
+
+	std::tuple<double, double, double, double>
+	Disordered::scattering_coefficients(double wavelength, const cml& n1, const cml& n2, 
+		double w1, double w2, double loss, size_t idx, size_t threads)
+	{
+		auto sparams = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		
+		// R and the phases are scale invariant, T carries the scale
+		const double scale = product(sparams.get(), wavelength, n1, n2, w1, w2, loss, idx, threads);
+
+		double R, T, r, t;
+
+		tmm::scattering_coefficients(sparams.get(), R, T, r, t);
+		T *= std::exp(-2.0 * scale);
+
+		return std::make_tuple(R, T, r, t);
+	}
+}//namespace tmm
@@ -0,0 +1,167 @@
+/**
+ * \file field.cc
+ * \brief implementations for field.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <field.h>
+#include <bragg.h>
+#include <pool.h>
+#include <iostream>
+
+namespace tmm
+{
+	namespace
+	{
+		constexpr size_t rows = 4096; ///< boundaries per chunk
+
+		/**
+		 * \brief Field at a period boundary
+		 */
+		struct sample
+		{
+			uint64_t k; ///< periods from the input port
+			double forward; ///< forward power relative to the incident wave
+			double backward; ///< backward power relative to the incident wave
+			std::complex<double> a; ///< forward amplitude relative to the incident wave
+			std::complex<double> b; ///< backward amplitude relative to the incident wave
+		};
+	}
+
+	int 
+	field(const ctl& ctx)
+	{
+		const double period = ctx.periods[0];
+		const double duty_cycle = ctx.duty_cycles[0];
+		const uint64_t N = static_cast<uint64_t>(ctx.Ns[0]);
+		const double w1 = ctx.width1.empty() ? 0.0 : ctx.width1[0];
+		const double w2 = ctx.width2.empty() ? 0.0 : ctx.width2[0];
+		const uint64_t D = std::max<uint64_t>(ctx.decimate, 1);
+		
+		Bragg grating(period, duty_cycle, N);
+		
+		printf("wavelength,period_index,z,forward,backward,energy,forward_re,forward_im,backward_re,backward_im\n");
+		
+		size_t idx = 0;
+		for (const auto& wavelength : ctx.wavelengths)
+		{
+			auto Tp = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			auto TD = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			auto TN = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			
+			grating.transfer_matrix(Tp.get(), wavelength, 
+				(*ctx.n1)(wavelength, w1, idx), 
+				(*ctx.n2)(wavelength, w2, idx), 
+				(*ctx.loss)(wavelength, 0.0, idx));
+			
+			// Incident amplitude T^N_00 of the unit output state, the fields are normalized to it
+			const double log_N = scaled_power(Tp.get(), TN.get(), N);
+			const double log_incident = std::log(std::abs(TN[0][0])) + log_N;
+			const double phase_incident = std::arg(TN[0][0]);
+			const double log_D = scaled_power(Tp.get(), TD.get(), D);
+			
+			// Written boundaries k = jD for j <= J, plus the output port
+			const uint64_t J = N / D;
+			const uint64_t total = J + 1 + (N % D ? 1 : 0);
+			const size_t chunks = (total + rows - 1) / rows;
+			const size_t wave = concurrency(ctx.threads) * 4;
+			
+			std::vector<std::vector<sample>> buffers(wave);
+			
+			for (size_t first = 0; first < chunks; first += wave)
+			{
+				const size_t count = std::min(wave, chunks - first);
+				
+				parallel_for(count, [&](size_t c, size_t)
+				{
+					auto& out = buffers[c];
+					out.clear();
+					
+					const uint64_t begin = (first + c) * rows;
+					const uint64_t end = std::min<uint64_t>(begin + rows, total);
+					
+					// Boundary of row r
+					auto boundary = [&](uint64_t r) { return r <= J ? r * D : N; };
+					
+					// State at the last boundary of the chunk, from its own prefix power
+					auto P = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+					uint64_t k = boundary(end - 1);
+					double log = scaled_power(Tp.get(), P.get(), N - k);
+					std::complex<double> a = P[0][0], b = P[1][0];
+					
+					out.resize(end - begin);
+					for (uint64_t r = end; r-- > begin;)
+					{
+						const uint64_t target = boundary(r);
+						
+						// Steps of D, except into the output port which is not a multiple of D
+						if (target != k)
+						{
+							auto S = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+							double log_S = log_D;
+							std::complex<double>** step = TD.get();
+							if (k - target != D)
+							{
+								log_S = scaled_power(Tp.get(), S.get(), k - target);
+								step = S.get();
+							}
+							
+							const std::complex<double> a_ = step[0][0] * a + step[0][1] * b;
+							const std::complex<double> b_ = step[1][0] * a + step[1][1] * b;
+							a = a_;
+							b = b_;
+							log += log_S;
+							k = target;
+							
+							const double m = std::max(std::abs(a), std::abs(b));
+							if (m > 1e100 || (m < 1e-100 && m > 0))
+							{
+								a /= m;
+								b /= m;
+								log += std::log(m);
+							}
+						}
+						
+						// Amplitudes relative to the incident wave, the powers follow from them
+						const std::complex<double> scale = std::polar(std::exp(log - log_incident), -phase_incident);
+						const std::complex<double> a_k = a * scale, b_k = b * scale;
+						out[r - begin] = {k, std::norm(a_k), std::norm(b_k), a_k, b_k};
+					}
+				}, ctx.threads);
+				
+				for (size_t c = 0; c < count; ++c)
+					for (const auto& s : buffers[c])
+						printf("%.6g,%llu,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g\n", wavelength, static_cast<unsigned long long>(s.k), 
+							s.k * period, s.forward, s.backward, s.forward + s.backward, 
+							s.a.real(), s.a.imag(), s.b.real(), s.b.imag());
+			}
+			
+			idx++;
+		}
+		
+		return 0;
+	}
+}//namespace tmm
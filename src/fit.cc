@@ -0,0 +1,358 @@
+/**
+ * \file fit.cc
+ * \brief implementations for fit.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <fit.h>
+#include <spectrum.h>
+#include <linalg.h>
+#include <pool.h>
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+#include <mutex>
+#include <algorithm>
+#include <limits>
+
+namespace tmm
+{
+	namespace
+	{
+		const char* fit_names[FIT_SIZE] = {"period", "n1", "n2", "width", "loss"};
+
+		/**
+		 * \brief Model R or T at one wavelength, with its sensitivity to every parameter
+		 */
+		double 
+		model(const ctl& ctx, const fit_vector& p, double wavelength, size_t idx, fit_vector* jacobian)
+		{
+			const double w1 = (ctx.width1.empty() ? 0.0 : ctx.width1[0]) + p[FIT_WIDTH];
+			const double w2 = (ctx.width2.empty() ? 0.0 : ctx.width2[0]) + p[FIT_WIDTH];
+			const double n1 = (*ctx.n1)(wavelength, w1, idx) + p[FIT_N1];
+			const double n2 = (*ctx.n2)(wavelength, w2, idx) + p[FIT_N2];
+			const double loss = (*ctx.loss)(wavelength, 0.0, idx) + p[FIT_LOSS];
+			
+			Bragg grating(p[FIT_PERIOD], ctx.duty_cycles[0], ctx.Ns[0]);
+			
+			auto S = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			grating.scattering_matrix(S.get(), wavelength, n1, n2, loss);
+			
+			double R, T, r, t;
+			tmm::scattering_coefficients(S.get(), R, T, r, t);
+			
+			if (jacobian)
+			{
+				auto S_bar = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+				scattering_adjoint(S.get(), ctx.measured_reflection ? 1.0 : 0.0, ctx.measured_reflection ? 0.0 : 1.0, S_bar.get());
+				
+				bragg_gradient g;
+				grating.scattering_matrix_adjoint(S_bar.get(), wavelength, n1, n2, loss, g);
+				
+				(*jacobian)[FIT_PERIOD] = g.period;
+				(*jacobian)[FIT_N1] = g.n1;
+				(*jacobian)[FIT_N2] = g.n2;
+				(*jacobian)[FIT_WIDTH] = g.n1 * ctx.n1->width_derivative(w1) + g.n2 * ctx.n2->width_derivative(w2);
+				(*jacobian)[FIT_LOSS] = g.loss;
+			}
+			
+			return ctx.measured_reflection ? R : T;
+		}
+
+		/**
+		 * \brief Residuals and Jacobian of the free parameters
+		 * \returns sum of squared residuals
+		 */
+		double 
+		residuals(const ctl& ctx, const fit_vector& p, const std::vector<double>& grid, const std::vector<double>& measured,
+			std::vector<double>& r, std::vector<double>* J)
+		{
+			const size_t m = grid.size();
+			const size_t n = ctx.fit_parameters.size();
+			double ssr = 0;
+			fit_vector row;
+			
+			for (size_t i = 0; i < m; ++i)
+			{
+				r[i] = model(ctx, p, grid[i], i, J ? &row : nullptr) - measured[i];
+				ssr += r[i] * r[i];
+				
+				if (J)
+					for (size_t j = 0; j < n; ++j)
+						(*J)[i * n + j] = row[ctx.fit_parameters[j]];
+			}
+			
+			return ssr;
+		}
+	}
+
+	fit_vector 
+	fit_initial(const ctl& ctx)
+	{
+		fit_vector p{};
+		p[FIT_PERIOD] = ctx.periods[0];
+		return p;
+	}
+
+	fit_result 
+	fit_spectrum(const ctl& ctx, const std::vector<double>& grid, const std::vector<double>& measured, const fit_vector& initial)
+	{
+		const size_t m = grid.size();
+		const size_t n = ctx.fit_parameters.size();
+		
+		fit_result result{.value = initial, .error = {}, .rms = 0, .iterations = 0};
+		fit_vector& p = result.value;
+		
+		std::vector<double> r(m), r_new(m), J(m * n), J_new(m * n), A(n * n), g(n);
+		
+		double ssr = residuals(ctx, p, grid, measured, r, &J);
+		double lambda = 1e-3;
+		
+		auto normal_equations = [&]()
+		{
+			for (size_t a = 0; a < n; ++a)
+			{
+				g[a] = 0;
+				for (size_t b = 0; b < n; ++b)
+					A[a * n + b] = 0;
+			}
+			for (size_t i = 0; i < m; ++i)
+				for (size_t a = 0; a < n; ++a)
+				{
+					g[a] += J[i * n + a] * r[i];
+					for (size_t b = 0; b < n; ++b)
+						A[a * n + b] += J[i * n + a] * J[i * n + b];
+				}
+		};
+		
+		normal_equations();
+		
+		for (; result.iterations < ctx.iterations; ++result.iterations)
+		{
+			// (A + lambda*diag(A)) delta = -g
+			std::vector<double> M = A, delta(n);
+			for (size_t a = 0; a < n; ++a)
+			{
+				M[a * n + a] += lambda * std::max(A[a * n + a], 1e-300);
+				delta[a] = -g[a];
+			}
+			
+			try
+			{
+				solve(M, delta, n);
+			}
+			catch (const std::exception&)
+			{
+				lambda *= 10;
+				continue;
+			}
+			
+			// The step predicts no further decrease
+			double predicted = 0;
+			for (size_t a = 0; a < n; ++a)
+				predicted -= delta[a] * g[a];
+			if (predicted <= 1e-12 * ssr)
+				break;
+			
+			fit_vector trial = p;
+			for (size_t a = 0; a < n; ++a)
+				trial[ctx.fit_parameters[a]] += delta[a];
+			
+			double ssr_new = residuals(ctx, trial, grid, measured, r_new, &J_new);
+			
+			if (ssr_new < ssr)
+			{
+				bool converged = (ssr - ssr_new) <= 1e-12 * ssr;
+				
+				p = trial;
+				ssr = ssr_new;
+				std::swap(r, r_new);
+				std::swap(J, J_new);
+				normal_equations();
+				lambda = std::max(lambda / 10, 1e-12);
+				
+				if (converged)
+					break;
+			}
+			else
+			{
+				lambda *= 10;
+				if (lambda > 1e12)
+					break;
+			}
+		}
+		
+		result.rms = std::sqrt(ssr / m);
+		
+		// Covariance s^2 (J^T J)^-1 of the free parameters
+		if (m > n)
+		{
+			try
+			{
+				auto cov = invert(A, n);
+				const double s2 = ssr / (m - n);
+				bool identifiable = true;
+				
+				for (size_t a = 0; a < n; ++a)
+				{
+					// A numerically negative variance flags a degenerate parameter combination
+					identifiable &= cov[a * n + a] > 0;
+					result.error[ctx.fit_parameters[a]] = cov[a * n + a] > 0 
+						? std::sqrt(cov[a * n + a] * s2) : std::numeric_limits<double>::infinity();
+				}
+				
+				if (!identifiable)
+					std::cerr << "[WARN] fit: ill-conditioned Jacobian, parameters are not identifiable" << std::endl;
+			}
+			catch (const std::exception&)
+			{
+				std::cerr << "[WARN] fit: singular Jacobian, parameters are not identifiable" << std::endl;
+			}
+		}
+		
+		return result;
+	}
+
+	int 
+	fit(const ctl& ctx)
+	{
+		auto spectra = load_spectra(ctx.measured);
+		
+		if (spectra.empty())
+		{
+			std::cerr << "[ERROR] fit: no spectrum in " << ctx.measured << std::endl;
+			return -1;
+		}
+		
+		const auto& grid = ctx.wavelengths.empty() ? spectra[0].wavelength : ctx.wavelengths;
+		auto measured = resample(spectra[0], grid);
+		
+		auto result = fit_spectrum(ctx, grid, measured, fit_initial(ctx));
+		
+		// Two sided 95% interval
+		const double z = 1.959964;
+		
+		printf("parameter,value,error,lower,upper\n");
+		for (auto i : ctx.fit_parameters)
+		{
+			printf("%s,%.9g,%.6g,%.9g,%.9g\n", fit_names[i], result.value[i], result.error[i],
+				result.value[i] - z * result.error[i], result.value[i] + z * result.error[i]);
+		}
+		
+		std::cerr << "[INFO] fit: rms " << result.rms << " after " << result.iterations << " iterations" << std::endl;
+		
+		return 0;
+	}
+
+	int 
+	fit_batch(const ctl& ctx)
+	{
+		std::vector<spectrum> spectra;
+		std::vector<std::string> sources;
+		
+		// A directory contributes every regular file in name order
+		std::vector<std::string> files;
+		if (std::filesystem::is_directory(ctx.measured))
+		{
+			for (const auto& entry : std::filesystem::directory_iterator(ctx.measured))
+				if (entry.is_regular_file())
+					files.push_back(entry.path().string());
+			std::sort(files.begin(), files.end());
+		}
+		else
+			files.push_back(ctx.measured);
+		
+		for (const auto& file : files)
+		{
+			for (auto& s : load_spectra(file))
+			{
+				spectra.push_back(std::move(s));
+				sources.push_back(std::filesystem::path(file).filename().string());
+			}
+		}
+		
+		if (spectra.empty())
+		{
+			std::cerr << "[ERROR] fit: no spectrum in " << ctx.measured << std::endl;
+			return -1;
+		}
+		
+		// Neighbouring spectra are fitted in order within a block, each starting from the previous solution
+		const size_t block = 16;
+		const size_t blocks = (spectra.size() + block - 1) / block;
+		const size_t threads = std::min(concurrency(ctx.threads), blocks);
+		
+		std::vector<fit_result> results(spectra.size());
+		std::vector<bool> done(spectra.size(), false);
+		size_t emitted = 0;
+		std::mutex output;
+		
+		printf("index,source");
+		for (auto i : ctx.fit_parameters)
+			printf(",%s,%s_error", fit_names[i], fit_names[i]);
+		printf(",rms,iterations\n");
+		
+		// Rows are streamed in input order as soon as all earlier spectra are done
+		auto emit = [&](size_t i)
+		{
+			std::lock_guard<std::mutex> lock(output);
+			done[i] = true;
+			
+			for (; emitted < spectra.size() && done[emitted]; ++emitted)
+			{
+				const auto& r = results[emitted];
+				printf("%zu,%s", emitted, sources[emitted].c_str());
+				for (auto j : ctx.fit_parameters)
+					printf(",%.9g,%.6g", r.value[j], r.error[j]);
+				printf(",%.6g,%zu\n", r.rms, r.iterations);
+			}
+		};
+		
+		auto start = std::chrono::steady_clock::now();
+		
+		parallel_for(blocks, [&](size_t b, size_t)
+		{
+			fit_vector initial = fit_initial(ctx);
+			
+			for (size_t i = b * block; i < std::min((b + 1) * block, spectra.size()); ++i)
+			{
+				const auto& grid = ctx.wavelengths.empty() ? spectra[i].wavelength : ctx.wavelengths;
+				auto measured = resample(spectra[i], grid);
+				
+				results[i] = fit_spectrum(ctx, grid, measured, initial);
+				initial = results[i].value;
+				
+				emit(i);
+			}
+		}, threads);
+		
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cerr << "[INFO] fit: " << spectra.size() << " spectra in " << elapsed.count() << " s, " 
+			<< spectra.size() / elapsed.count() / threads << " spectra/s/core" << std::endl;
+		
+		return 0;
+	}
+}//namespace tmm
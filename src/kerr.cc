@@ -0,0 +1,265 @@
+/**
+ * \file kerr.cc
+ * \brief implementations for kerr.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <kerr.h>
+#include <tmm.h>
+#include <pool.h>
+#include <iostream>
+#include <algorithm>
+
+namespace tmm
+{
+	namespace
+	{
+		constexpr double tolerance = 1e-10; ///< relative change of the power profile at convergence
+		constexpr double max_change = 0.02; ///< largest change of the transmission per step
+
+		/**
+		 * \brief Linear factors of one period, shared by every nonlinear solve at a wavelength
+		 * 
+		 * The Kerr shift dn of a layer of length l only multiplies its diagonal propagation 
+		 * matrix by diag(exp(i k0 dn l), exp(-i k0 dn l)); the index steps are kept linear.
+		 */
+		struct linear_period : protected TMM
+		{
+			std::complex<double> p1, q1; ///< diagonal of the first layer
+			std::complex<double> p2, q2; ///< diagonal of the second layer
+			std::complex<double> a12, b12; ///< index step from n1 to n2
+			std::complex<double> a21, b21; ///< index step from n2 to n1
+			double phase1, phase2; ///< k0 * l of each layer
+
+			linear_period(double wavelength, double period, double duty_cycle, double n1, double n2, double loss)
+			{
+				const double l1 = period * duty_cycle;
+				const double l2 = period * (1.0 - duty_cycle);
+				
+				auto P = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+				homogeneous_layer(P.get(), wavelength, l1, n1, loss);
+				p1 = P[0][0]; q1 = P[1][1];
+				homogeneous_layer(P.get(), wavelength, l2, n2, loss);
+				p2 = P[0][0]; q2 = P[1][1];
+				
+				index_step(P.get(), n1, n2);
+				a12 = P[0][0]; b12 = P[0][1];
+				index_step(P.get(), n2, n1);
+				a21 = P[0][0]; b21 = P[0][1];
+				
+				const double k0 = 2.0 * pi / wavelength;
+				phase1 = k0 * l1;
+				phase2 = k0 * l2;
+			}
+
+			/**
+			 * \brief Propagates the state at the right of a period to its left
+			 * \param dn Kerr index shift of the period
+			 */
+			void backward(std::complex<double>& a, std::complex<double>& b, double dn) const
+			{
+				const std::complex<double> e1 = std::polar(1.0, phase1 * dn);
+				const std::complex<double> e2 = std::polar(1.0, phase2 * dn);
+				
+				std::complex<double> x = a21 * a + b21 * b, y = b21 * a + a21 * b;
+				x *= p2 * e2; y *= q2 / e2;
+				a = a12 * x + b12 * y; b = b12 * x + a12 * y;
+				a *= p1 * e1; b *= q1 / e1;
+			}
+		};
+
+		/**
+		 * \brief Point of the bistability curve
+		 */
+		struct operating_point
+		{
+			double output; ///< transmitted power
+			double input; ///< incident power
+			double reflected; ///< reflected power
+			size_t iterations; ///< fixed-point iterations of the power profile
+		};
+
+		/**
+		 * \brief Self-consistent backward integration from a fixed output power
+		 * 
+		 * \param I power at each period boundary, the initial guess on entry
+		 * \returns the operating point, iterations exceeding the limit when not converged
+		 */
+		operating_point 
+		solve(const linear_period& lin, double kerr, double output, std::vector<double>& I, size_t limit)
+		{
+			const size_t N = I.size() - 1;
+			operating_point p{output, 0, 0, 0};
+			
+			while (p.iterations++ < limit)
+			{
+				std::complex<double> a = std::sqrt(output), b = 0;
+				double change = 0, scale = output;
+				
+				I[N] = output;
+				for (size_t k = N; k > 0; --k)
+				{
+					// Left boundary from the previous sweep, right boundary already updated
+					lin.backward(a, b, kerr * 0.5 * (I[k - 1] + I[k]));
+					
+					const double power = std::norm(a) + std::norm(b);
+					change = std::max(change, std::abs(power - I[k - 1]));
+					scale = std::max(scale, power);
+					I[k - 1] = power;
+				}
+				
+				p.input = std::norm(a);
+				p.reflected = std::norm(b);
+				if (change <= tolerance * scale)
+					return p;
+			}
+			return p;
+		}
+
+		/**
+		 * \brief Continuation in output power at one wavelength
+		 */
+		std::vector<operating_point> 
+		continuation(const ctl& ctx, const linear_period& lin, size_t N)
+		{
+			const double first = ctx.power.size() > 1 ? ctx.power[0] : 0.0;
+			const double last = ctx.power.back();
+			const double h_max = (last - first) / std::max<size_t>(ctx.steps, 1);
+			const double h_min = h_max * 1e-6;
+			
+			std::vector<double> I(N + 1, first), trial;
+			std::vector<operating_point> curve{solve(lin, ctx.kerr, first, I, ctx.iterations)};
+			
+			double h = h_max;
+			double output = first;
+			while (output < last)
+			{
+				h = std::min(h, last - output);
+				trial = I;
+				
+				// Previous profile scaled to the new output power as the initial guess
+				const double ratio = output > 0 ? (output + h) / output : 1.0;
+				for (auto& x : trial)
+					x *= ratio;
+				
+				const auto p = solve(lin, ctx.kerr, output + h, trial, ctx.iterations);
+				const auto& q = curve.back();
+				
+				const bool converged = p.iterations <= ctx.iterations;
+				const bool smooth = q.input <= 0 || p.input <= 0 
+					|| std::abs(p.output / p.input - q.output / q.input) <= max_change;
+				if ((!converged || !smooth) && h > h_min)
+				{
+					h *= 0.5;
+					continue;
+				}
+				
+				output += h;
+				curve.push_back(p);
+				std::swap(I, trial);
+				h = std::min(2.0 * h, h_max);
+			}
+			
+			return curve;
+		}
+	}
+
+	int 
+	kerr(const ctl& ctx)
+	{
+		const double period = ctx.periods[0];
+		const double duty_cycle = ctx.duty_cycles[0];
+		const size_t N = static_cast<size_t>(ctx.Ns[0]);
+		const double w1 = ctx.width1.empty() ? 0.0 : ctx.width1[0];
+		const double w2 = ctx.width2.empty() ? 0.0 : ctx.width2[0];
+		const size_t wave = concurrency(ctx.threads) * 4;
+		
+		printf("wavelength,output_power,input_power,reflected_power,R,T,iterations,stable,up,down\n");
+		
+		size_t failed = 0, points = 0;
+		std::vector<std::vector<operating_point>> curves(wave);
+		
+		for (size_t begin = 0; begin < ctx.wavelengths.size(); begin += wave)
+		{
+			const size_t count = std::min(wave, ctx.wavelengths.size() - begin);
+			
+			parallel_for(count, [&](size_t j, size_t)
+			{
+				const size_t idx = begin + j;
+				const double wavelength = ctx.wavelengths[idx];
+				
+				const linear_period lin(wavelength, period, duty_cycle, 
+					(*ctx.n1)(wavelength, w1, idx), 
+					(*ctx.n2)(wavelength, w2, idx), 
+					(*ctx.loss)(wavelength, 0.0, idx));
+				
+				curves[j] = continuation(ctx, lin, N);
+			}, ctx.threads);
+			
+			for (size_t j = 0; j < count; ++j)
+			{
+				const auto& curve = curves[j];
+				const size_t n = curve.size();
+				
+				// Sweeping the input power up (down) follows a point only if no earlier (later) 
+				// point of the curve needs a higher (lower) input power
+				std::vector<bool> up(n), down(n);
+				double highest = -1.0, lowest = INFINITY;
+				for (size_t i = 0; i < n; ++i)
+				{
+					up[i] = curve[i].input >= highest;
+					highest = std::max(highest, curve[i].input);
+				}
+				for (size_t i = n; i-- > 0;)
+				{
+					down[i] = curve[i].input <= lowest;
+					lowest = std::min(lowest, curve[i].input);
+				}
+				
+				for (size_t i = 0; i < n; ++i)
+				{
+					const auto& p = curve[i];
+					const size_t l = i ? i - 1 : i, r = i + 1 < n ? i + 1 : i;
+					const bool stable = curve[r].input - curve[l].input >= 0;
+					
+					failed += p.iterations > ctx.iterations;
+					printf("%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%zu,%d,%d,%d\n", ctx.wavelengths[begin + j], 
+						p.output, p.input, p.reflected, 
+						p.input > 0 ? p.reflected / p.input : NAN, 
+						p.input > 0 ? p.output / p.input : NAN, 
+						p.iterations, stable, static_cast<int>(up[i]), static_cast<int>(down[i]));
+				}
+				points += n;
+			}
+		}
+		
+		if (failed)
+			std::cerr << "[WARN] kerr: " << failed << " of " << points << " points did not converge within " 
+				<< ctx.iterations << " iterations" << std::endl;
+		
+		return 0;
+	}
+}//namespace tmm
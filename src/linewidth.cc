@@ -0,0 +1,178 @@
+/**
+ * \file linewidth.cc
+ * \brief implementations for linewidth.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <linewidth.h>
+#include <linalg.h>
+#include <algorithm>
+#include <numbers>
+#include <cmath>
+
+namespace tmm
+{
+	namespace
+	{
+		constexpr size_t oversample = 8; ///< grid points per FWHM when the sweep is coarser than the line
+		constexpr size_t hermite_nodes = 16; ///< Gauss-Hermite nodes per wavelength for Gaussian lines
+
+		/**
+		 * \brief Half width of the kernel support, in units of the FWHM
+		 * 
+		 * Gaussians are cut at 4 sigma; the Lorentzian and sinc^2 tails are cut and the 
+		 * remaining weights renormalized.
+		 */
+		double support(lineshape_t shape)
+		{
+			switch (shape)
+			{
+				case LINE_LORENTZIAN: return 10.0;
+				case LINE_SINC2: return 4.0;
+				default: return 4.0 / (2.0 * std::sqrt(2.0 * std::numbers::ln2));
+			}
+		}
+
+		/**
+		 * \brief Unnormalized line shape of unit FWHM at offset x
+		 */
+		double kernel(lineshape_t shape, double x)
+		{
+			switch (shape)
+			{
+				case LINE_LORENTZIAN: 
+					return 1.0 / (1.0 + 4.0 * x * x);
+				case LINE_SINC2:
+				{
+					// sinc^2(pi x / x0) has its FWHM at x0 = 1/0.885893
+					const double u = std::numbers::pi * x * 0.885893;
+					return u == 0 ? 1.0 : std::pow(std::sin(u) / u, 2);
+				}
+				default: 
+					return std::exp(-4.0 * std::numbers::ln2 * x * x);
+			}
+		}
+	}
+
+	spectral_average::spectral_average(const ctl& ctx)
+	{
+		const auto& wavelengths = ctx.wavelengths;
+		const size_t K = wavelengths.size();
+		const double fwhm = ctx.linewidth;
+		const double reach = support(ctx.lineshape) * fwhm;
+		
+		_offsets.assign(1, 0);
+		_nominal.assign(K, npos);
+		
+		// Weights of one window on a grid of spacing h from first, covering [lo, hi)
+		auto window = [&](double wavelength, double first, double h, size_t count)
+		{
+			const double lo = std::ceil((wavelength - reach - first) / h);
+			const double hi = std::floor((wavelength + reach - first) / h);
+			const size_t begin = static_cast<size_t>(std::max(lo, 0.0));
+			const size_t end = static_cast<size_t>(std::min(hi + 1.0, static_cast<double>(count)));
+			
+			double total = 0;
+			const size_t start = _weight.size();
+			for (size_t j = begin; j < end; ++j)
+			{
+				const double w = kernel(ctx.lineshape, (first + j * h - wavelength) / fwhm);
+				_index.push_back(j);
+				_weight.push_back(w);
+				total += w;
+			}
+			for (size_t i = start; i < _weight.size(); ++i)
+				_weight[i] /= total;
+			_offsets.push_back(_weight.size());
+		};
+		
+		// A uniform sweep at least twice finer than the line is its own grid, extended by the support
+		bool uniform = K > 1;
+		const double step = K > 1 ? (wavelengths.back() - wavelengths.front()) / (K - 1) : 0.0;
+		for (size_t k = 1; k < K && uniform; ++k)
+			uniform = std::abs(wavelengths[k] - wavelengths[k - 1] - step) <= 1e-9 * std::abs(step);
+		
+		if (uniform && step > 0 && step <= 0.5 * fwhm)
+		{
+			const size_t pad = static_cast<size_t>(std::ceil(reach / step));
+			const double first = wavelengths.front() - pad * step;
+			const size_t count = K + 2 * pad;
+			
+			for (size_t j = 0; j < count; ++j)
+				_points.push_back(first + j * step);
+			for (size_t k = 0; k < K; ++k)
+			{
+				window(first + (k + pad) * step, first, step, count);
+				_nominal[k] = k + pad;
+			}
+			return;
+		}
+		
+		// Otherwise an oversampled grid over the union of the windows, or Gauss-Hermite 
+		// nodes per wavelength for Gaussian lines when that takes fewer evaluations
+		const auto [lmin, lmax] = std::minmax_element(wavelengths.begin(), wavelengths.end());
+		const double h = fwhm / oversample;
+		const size_t count = static_cast<size_t>(std::ceil((*lmax - *lmin + 2 * reach) / h)) + 1;
+		
+		if (ctx.lineshape == LINE_GAUSSIAN && K * hermite_nodes < count)
+		{
+			// Probabilists' Hermite rule by Golub-Welsch, nodes in units of sigma
+			std::vector<double> nodes(hermite_nodes, 0.0), e(hermite_nodes, 0.0), weights;
+			for (size_t n = 1; n < hermite_nodes; ++n)
+				e[n] = std::sqrt(static_cast<double>(n));
+			tridiagonal_eigen(nodes, e, weights);
+			
+			const double sigma = fwhm / (2.0 * std::sqrt(2.0 * std::numbers::ln2));
+			for (size_t k = 0; k < K; ++k)
+			{
+				for (size_t q = 0; q < hermite_nodes; ++q)
+				{
+					_index.push_back(_points.size());
+					_points.push_back(wavelengths[k] + sigma * nodes[q]);
+					_weight.push_back(weights[q] * weights[q]);
+				}
+				_offsets.push_back(_weight.size());
+			}
+			return;
+		}
+		
+		const double first = *lmin - reach;
+		for (size_t k = 0; k < K; ++k)
+			window(wavelengths[k], first, h, count);
+		
+		// Only grid points inside some window are evaluated
+		std::vector<size_t> remap(count, npos);
+		for (auto& j : _index)
+		{
+			if (remap[j] == npos)
+			{
+				remap[j] = _points.size();
+				_points.push_back(first + j * h);
+			}
+			j = remap[j];
+		}
+	}
+}//namespace tmm
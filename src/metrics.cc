@@ -0,0 +1,76 @@
+/**
+ * \file metrics.cc
+ * \brief implementations for metrics.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <metrics.h>
+#include <algorithm>
+
+namespace tmm
+{
+	summary 
+	summarize(const std::vector<double>& wavelengths, const std::vector<double>& R)
+	{
+		summary s;
+		const size_t W = R.size();
+		if (W == 0)
+			return s;
+		
+		const size_t p = std::max_element(R.begin(), R.end()) - R.begin();
+		s.peak = R[p];
+		s.center = wavelengths[p];
+		
+		const double half = s.peak / 2;
+		
+		// Half maximum crossings
+		size_t l = p, r = p;
+		while (l > 0 && R[l - 1] >= half)
+			l--;
+		while (r + 1 < W && R[r + 1] >= half)
+			r++;
+		
+		double lower = wavelengths[l], upper = wavelengths[r];
+		if (l > 0)
+			lower -= (wavelengths[l] - wavelengths[l - 1]) * (R[l] - half) / (R[l] - R[l - 1]);
+		if (r + 1 < W)
+			upper += (wavelengths[r + 1] - wavelengths[r]) * (R[r] - half) / (R[r] - R[r + 1]);
+		s.bandwidth = upper - lower;
+		
+		// Main lobe down to the first minima
+		while (l > 0 && R[l - 1] <= R[l])
+			l--;
+		while (r + 1 < W && R[r + 1] <= R[r])
+			r++;
+		
+		for (size_t i = 0; i < l; ++i)
+			s.sidelobe = std::max(s.sidelobe, R[i]);
+		for (size_t i = r + 1; i < W; ++i)
+			s.sidelobe = std::max(s.sidelobe, R[i]);
+		
+		return s;
+	}
+}//namespace tmm
@@ -0,0 +1,271 @@
+/**
+ * \file montecarlo.cc
+ * \brief implementations for montecarlo.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <montecarlo.h>
+#include <rng.h>
+#include <pool.h>
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace tmm
+{
+	namespace
+	{
+		static constexpr size_t bins = 1000; ///< histogram resolution of R and T on [0, 1]
+		static constexpr size_t block = 256; ///< samples per reduction block
+
+		/**
+		 * \brief Streaming reduction of sampled spectra
+		 * 
+		 * Counts are exact in any order and are kept per thread. Floating point moments 
+		 * are accumulated per block and folded into the running total in block order, so 
+		 * they are reproducible for any thread count.
+		 */
+		struct counts
+		{
+			size_t passed = 0;
+			std::vector<size_t> pass; ///< passes per wavelength
+			std::vector<uint64_t> R_hist, T_hist; ///< wavelength-major histograms
+			
+			explicit counts(size_t wavelengths) :
+			pass(wavelengths, 0), R_hist(wavelengths * bins, 0), T_hist(wavelengths * bins, 0)
+			{ }
+			
+			void merge(const counts& other)
+			{
+				passed += other.passed;
+				for (size_t i = 0; i < pass.size(); ++i)
+					pass[i] += other.pass[i];
+				for (size_t i = 0; i < R_hist.size(); ++i)
+				{
+					R_hist[i] += other.R_hist[i];
+					T_hist[i] += other.T_hist[i];
+				}
+			}
+		};
+
+		/**
+		 * \brief Means and centred second moments of R and T per wavelength
+		 * 
+		 * Samples are added by Welford's update and partial results combined by Chan's 
+		 * pairwise formula, avoiding the cancellation of E[x^2] - E[x]^2.
+		 */
+		struct moments
+		{
+			size_t n = 0;
+			std::vector<double> R, R_M2, T, T_M2;
+			
+			explicit moments(size_t wavelengths) :
+			R(wavelengths, 0), R_M2(wavelengths, 0), T(wavelengths, 0), T_M2(wavelengths, 0)
+			{ }
+			
+			void add(const std::vector<double>& R_, const std::vector<double>& T_)
+			{
+				++n;
+				for (size_t i = 0; i < R.size(); ++i)
+				{
+					const double dR = R_[i] - R[i];
+					R[i] += dR / n;
+					R_M2[i] += dR * (R_[i] - R[i]);
+					const double dT = T_[i] - T[i];
+					T[i] += dT / n;
+					T_M2[i] += dT * (T_[i] - T[i]);
+				}
+			}
+			
+			void merge(const moments& other)
+			{
+				if (other.n == 0)
+					return;
+				
+				const double na = static_cast<double>(n), nb = static_cast<double>(other.n);
+				const double total = na + nb;
+				for (size_t i = 0; i < R.size(); ++i)
+				{
+					const double dR = other.R[i] - R[i];
+					R[i] += dR * nb / total;
+					R_M2[i] += other.R_M2[i] + dR * dR * na * nb / total;
+					const double dT = other.T[i] - T[i];
+					T[i] += dT * nb / total;
+					T_M2[i] += other.T_M2[i] + dT * dT * na * nb / total;
+				}
+				n += other.n;
+			}
+		};
+
+		size_t bin(double v)
+		{
+			return std::min(static_cast<size_t>(std::max(v, 0.0) * bins), bins - 1);
+		}
+
+		/**
+		 * \brief Quantile q from a histogram on [0, 1], linear within the bin
+		 */
+		double quantile(const uint64_t* hist, size_t total, double q)
+		{
+			const double target = q * total;
+			double cumulative = 0;
+			
+			for (size_t b = 0; b < bins; ++b)
+			{
+				if (cumulative + hist[b] >= target && hist[b] > 0)
+					return (b + (target - cumulative) / hist[b]) / bins;
+				cumulative += hist[b];
+			}
+			
+			return 1.0;
+		}
+	}
+
+	void 
+	perturbed_spectrum(const ctl& ctx, const offset_vector& offset, std::vector<double>& R, std::vector<double>& T)
+	{
+		const double w1 = (ctx.width1.empty() ? 0.0 : ctx.width1[0]) + offset[VAR_W1];
+		const double w2 = (ctx.width2.empty() ? 0.0 : ctx.width2[0]) + offset[VAR_W2];
+		
+		Bragg grating(ctx.periods[0] + offset[VAR_PERIOD], 
+			std::clamp(ctx.duty_cycles[0] + offset[VAR_DUTY_CYCLE], 0.0, 1.0), 
+			ctx.Ns[0]);
+		
+		R.resize(ctx.wavelengths.size());
+		T.resize(ctx.wavelengths.size());
+		
+		size_t idx = 0;
+		for (const auto& wavelength : ctx.wavelengths)
+		{
+			auto [R_, T_, r, t] = grating.scattering_coefficients(
+				wavelength,
+				(*ctx.n1)(wavelength, w1, idx) + offset[VAR_N1],
+				(*ctx.n2)(wavelength, w2, idx) + offset[VAR_N2],
+				(*ctx.loss)(wavelength, 0.0, idx) + offset[VAR_LOSS],
+				false
+			);
+			
+			R[idx] = R_;
+			T[idx] = T_;
+			idx++;
+		}
+	}
+
+	int 
+	montecarlo(const ctl& ctx)
+	{
+		const size_t W = ctx.wavelengths.size();
+		const size_t blocks = (ctx.samples + block - 1) / block;
+		const philox rng(ctx.seed);
+		
+		const size_t threads = std::min(concurrency(ctx.threads), std::max<size_t>(blocks, 1));
+		
+		std::vector<counts> thread_counts(threads, counts(W));
+		
+		// Blocks finished ahead of the next one in order wait in pending
+		moments total_moments(W);
+		std::map<size_t, moments> pending;
+		size_t next_block = 0;
+		std::mutex fold;
+		
+		parallel_for(blocks, [&](size_t b, size_t thread)
+		{
+			counts& c = thread_counts[thread];
+			moments r(W);
+			std::vector<double> R, T;
+			
+			for (size_t s = b * block; s < std::min((b + 1) * block, ctx.samples); ++s)
+			{
+				offset_vector offset{};
+				
+				// Stream j of sample s is reserved for variation j
+				for (size_t j = 0; j < ctx.variations.size(); ++j)
+				{
+					const auto& v = ctx.variations[j];
+					double u = v.distribution == NORMAL ? rng.normal(s, j) : rng.uniform(s, j)[0];
+					offset[v.variable] += v(u, u);
+				}
+				
+				perturbed_spectrum(ctx, offset, R, T);
+				
+				bool pass = true;
+				for (size_t i = 0; i < W; ++i)
+				{
+					bool ok = ctx.target.pass(i, R[i], T[i]);
+					pass &= ok;
+					c.pass[i] += ok;
+					c.R_hist[i * bins + bin(R[i])]++;
+					c.T_hist[i * bins + bin(T[i])]++;
+				}
+				c.passed += pass;
+				r.add(R, T);
+			}
+			
+			std::lock_guard lock(fold);
+			pending.emplace(b, std::move(r));
+			for (auto it = pending.begin(); it != pending.end() && it->first == next_block; it = pending.erase(it))
+			{
+				total_moments.merge(it->second);
+				++next_block;
+			}
+		}, threads);
+		
+		counts total(W);
+		for (const auto& c : thread_counts)
+			total.merge(c);
+		
+		const double n = static_cast<double>(ctx.samples);
+		
+		printf("wavelength,R_mean,R_std");
+		for (auto q : ctx.quantiles) printf(",R_q%g", q);
+		printf(",T_mean,T_std");
+		for (auto q : ctx.quantiles) printf(",T_q%g", q);
+		printf(",pass\n");
+		
+		for (size_t i = 0; i < W; ++i)
+		{
+			const double R_mean = total_moments.R[i];
+			const double T_mean = total_moments.T[i];
+			const double R_std = std::sqrt(total_moments.R_M2[i] / n);
+			const double T_std = std::sqrt(total_moments.T_M2[i] / n);
+			
+			printf("%.6g,%.6g,%.6g", ctx.wavelengths[i], R_mean, R_std);
+			for (auto q : ctx.quantiles) 
+				printf(",%.6g", quantile(&total.R_hist[i * bins], ctx.samples, q));
+			printf(",%.6g,%.6g", T_mean, T_std);
+			for (auto q : ctx.quantiles) 
+				printf(",%.6g", quantile(&total.T_hist[i * bins], ctx.samples, q));
+			printf(",%.6g\n", total.pass[i] / n);
+		}
+		
+		const double yield = total.passed / n;
+		std::cerr << "[INFO] montecarlo: yield " << yield << " +/- " << std::sqrt(yield * (1 - yield) / n)
+			<< " (" << total.passed << "/" << ctx.samples << ")" << std::endl;
+		
+		return 0;
+	}
+}//namespace tmm
@@ -0,0 +1,507 @@
+/**
+ * \file optimize.cc
+ * \brief implementations for optimize.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <optimize.h>
+#include <lbfgs.h>
+#include <pool.h>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <random>
+#include <map>
+
+namespace tmm
+{
+	namespace
+	{
+		/**
+		 * \brief A free design variable, normalized to [0, 1] over its bounds
+		 */
+		struct parameter
+		{
+			size_t index; ///< section index
+			double section::* field; ///< section member
+			double lower; ///< lower bound
+			double upper; ///< upper bound
+			bool integer = false; ///< rounded to the nearest integer
+		};
+
+		/**
+		 * \brief Write normalized coordinates x into the sections
+		 */
+		void 
+		apply(const std::vector<parameter>& parameters, const std::vector<double>& x, std::vector<section>& sections)
+		{
+			for (size_t i = 0; i < parameters.size(); ++i)
+			{
+				const auto& p = parameters[i];
+				double v = p.lower + x[i] * (p.upper - p.lower);
+				sections[p.index].*p.field = p.integer ? std::round(v) : v;
+			}
+		}
+
+		/**
+		 * \brief Initial sections and free parameters from the sweep axes
+		 * 
+		 * \param discrete include the integer period count of each section
+		 */
+		void 
+		design_space(const ctl& ctx, std::vector<section>& sections, std::vector<parameter>& parameters, bool discrete)
+		{
+			auto first = [](const std::vector<double>& axis) { return axis.empty() ? 0.0 : axis[0]; };
+			
+			auto mid = [&](const std::vector<double>& axis)
+			{
+				if (axis.size() < 2)
+					return first(axis);
+				auto [lo, hi] = std::minmax_element(axis.begin(), axis.end());
+				return (*lo + *hi) / 2.0;
+			};
+			
+			const size_t K = std::max<size_t>(ctx.sections, 1);
+			const size_t N = static_cast<size_t>(first(ctx.Ns));
+			
+			sections.assign(K, section{
+				.period = mid(ctx.periods),
+				.duty_cycle = mid(ctx.duty_cycles),
+				.N = 0,
+				.w1 = mid(ctx.width1),
+				.w2 = mid(ctx.width2)
+			});
+			
+			// Distribute the periods over the sections
+			for (size_t k = 0; k < K; ++k)
+				sections[k].N = static_cast<double>(N / K + (k < N % K ? 1 : 0));
+			
+			// Axes of one distinct value stay fixed, normalizing them would divide by zero
+			auto add = [&](const std::vector<double>& axis, double section::* field, double scale = 1.0)
+			{
+				if (axis.size() < 2)
+					return false;
+				auto [lo, hi] = std::minmax_element(axis.begin(), axis.end());
+				if (*lo == *hi)
+					return false;
+				for (size_t k = 0; k < K; ++k)
+					parameters.push_back(parameter{k, field, *lo * scale, *hi * scale, field == &section::N});
+				return true;
+			};
+			
+			if (discrete && add(ctx.Ns, &section::N, 1.0 / K))
+			{
+				for (auto& s : sections)
+					s.N = std::round(mid(ctx.Ns) / K);
+			}
+			
+			add(ctx.periods, &section::period);
+			add(ctx.duty_cycles, &section::duty_cycle);
+			
+			if (ctx.n1->width_model)
+				add(ctx.width1, &section::w1);
+			if (ctx.n2->width_model)
+				add(ctx.width2, &section::w2);
+		}
+	}
+
+	double 
+	objective(const ctl& ctx, const std::vector<section>& sections, std::vector<section>* gradient)
+	{
+		const size_t K = sections.size();
+		
+		// M[k] section matrices, prefix[k] = M[0]...M[k-1]
+		auto M = damm::aligned_alloc_2D<std::complex<double>, 64>(2 * K, 2);
+		auto prefix = damm::aligned_alloc_2D<std::complex<double>, 64>(2 * (K + 1), 2);
+		auto suffix = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto S_bar = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto M_bar = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto work = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		
+		if (gradient)
+			gradient->assign(K, section{0, 0, 0, 0, 0});
+		
+		double J = 0;
+		size_t idx = 0;
+		
+		for (const auto& wavelength : ctx.wavelengths)
+		{
+			const double loss = (*ctx.loss)(wavelength, 0.0, idx);
+			
+			damm::identity<std::complex<double>, damm::NONE>(prefix.get(), 2, 2);
+			
+			for (size_t k = 0; k < K; ++k)
+			{
+				const auto& s = sections[k];
+				Bragg grating(s.period, s.duty_cycle, s.N);
+				
+				grating.scattering_matrix(M.get() + 2 * k, wavelength,
+					(*ctx.n1)(wavelength, s.w1, idx), 
+					(*ctx.n2)(wavelength, s.w2, idx), 
+					loss);
+				
+				damm::zeros<std::complex<double>, damm::NONE>(prefix.get() + 2 * (k + 1), 2, 2);
+				damm::multiply<std::complex<double>, damm::NONE>(prefix.get() + 2 * k, M.get() + 2 * k, prefix.get() + 2 * (k + 1), 2, 2, 2);
+			}
+			
+			std::complex<double>** S = prefix.get() + 2 * K;
+			
+			double R, T, r, t, dR, dT;
+			tmm::scattering_coefficients(S, R, T, r, t);
+			J += ctx.target.penalty(idx, R, T, &dR, &dT);
+			
+			if (gradient && (dR != 0 || dT != 0))
+			{
+				scattering_adjoint(S, dR, dT, S_bar.get());
+				damm::identity<std::complex<double>, damm::NONE>(suffix.get(), 2, 2);
+				
+				// M_bar[k] = prefix[k]^H * S_bar * suffix[k]^H
+				for (size_t k = K; k-- > 0;)
+				{
+					const auto& s = sections[k];
+					Bragg grating(s.period, s.duty_cycle, s.N);
+					
+					multiply_hermitian_lhs(prefix.get() + 2 * k, S_bar.get(), work.get());
+					multiply_hermitian_rhs(work.get(), suffix.get(), M_bar.get());
+					
+					const double n1 = (*ctx.n1)(wavelength, s.w1, idx);
+					const double n2 = (*ctx.n2)(wavelength, s.w2, idx);
+					
+					bragg_gradient g;
+					grating.scattering_matrix_adjoint(M_bar.get(), wavelength, n1, n2, loss, g);
+					
+					auto& G = (*gradient)[k];
+					G.period += g.period;
+					G.duty_cycle += g.duty_cycle;
+					G.w1 += g.n1 * ctx.n1->width_derivative(s.w1);
+					G.w2 += g.n2 * ctx.n2->width_derivative(s.w2);
+					
+					// suffix = M[k] * suffix
+					damm::zeros<std::complex<double>, damm::NONE>(work.get(), 2, 2);
+					damm::multiply<std::complex<double>, damm::NONE>(M.get() + 2 * k, suffix.get(), work.get(), 2, 2, 2);
+					for (size_t i = 0; i < 2; ++i)
+						for (size_t j = 0; j < 2; ++j)
+							suffix[i][j] = work[i][j];
+				}
+			}
+			
+			idx++;
+		}
+		
+		return J;
+	}
+
+	namespace
+	{
+		/**
+		 * \brief Gradient based local search from the centre of the design space
+		 */
+		double 
+		minimize_lbfgs(const ctl& ctx, std::vector<section>& sections, const std::vector<parameter>& parameters, std::vector<double>& x)
+		{
+			const size_t n = parameters.size();
+			std::vector<double> lower(n, 0.0), upper(n, 1.0);
+			std::vector<section> gradient;
+			
+			auto f = [&](const std::vector<double>& v, std::vector<double>& g)
+			{
+				apply(parameters, v, sections);
+				
+				double J = objective(ctx, sections, &gradient);
+				
+				for (size_t i = 0; i < n; ++i)
+				{
+					const auto& p = parameters[i];
+					g[i] = gradient[p.index].*p.field * (p.upper - p.lower);
+				}
+				
+				return J;
+			};
+			
+			auto progress = [](size_t iteration, double J)
+			{
+				std::cerr << "[INFO] optimize: iteration " << iteration << " objective " << J << std::endl;
+			};
+			
+			return lbfgs(f, x, lower, upper, lbfgs_options{.max_iterations = ctx.iterations}, progress);
+		}
+
+		/**
+		 * \brief Restore a differential evolution population from a checkpoint
+		 * \returns the generation to resume from, 0 if the checkpoint is absent or incompatible
+		 */
+		size_t 
+		load_checkpoint(const std::string& path, std::vector<std::vector<double>>& population, std::vector<double>& cost)
+		{
+			std::ifstream in(path);
+			size_t generation, size, dims;
+			
+			if (!in || !(in >> generation >> size >> dims) 
+				|| size != population.size() || dims != population[0].size())
+				return 0;
+			
+			for (size_t i = 0; i < size; ++i)
+			{
+				for (auto& v : population[i])
+					in >> v;
+				in >> cost[i];
+			}
+			
+			return in ? generation : 0;
+		}
+
+		/**
+		 * \brief Save a differential evolution population
+		 * 
+		 * Written to a temporary file and renamed so an interrupted write never
+		 * replaces the previous checkpoint.
+		 */
+		void 
+		save_checkpoint(const std::string& path, size_t generation, 
+			const std::vector<std::vector<double>>& population, const std::vector<double>& cost)
+		{
+			const std::string tmp = path + ".tmp";
+			{
+				std::ofstream out(tmp);
+				out.precision(17);
+				out << generation << " " << population.size() << " " << population[0].size() << "\n";
+				for (size_t i = 0; i < population.size(); ++i)
+				{
+					for (auto v : population[i])
+						out << v << " ";
+					out << cost[i] << "\n";
+				}
+				if (!out)
+					throw std::runtime_error("failed to write checkpoint " + tmp);
+			}
+			if (std::rename(tmp.c_str(), path.c_str()) != 0)
+				throw std::runtime_error("failed to replace checkpoint " + path + ": " + std::strerror(errno));
+		}
+
+		/**
+		 * \brief Global search by differential evolution
+		 * 
+		 * DE/rand/1/bin over the normalized design space. Trial vectors are drawn 
+		 * serially so a run is reproducible for a given seed regardless of the thread count,
+		 * then each generation is evaluated in parallel. Candidates are memoized on their
+		 * decoded parameters, so rounded period counts and repeated trials are solved once.
+		 */
+		double 
+		minimize_de(const ctl& ctx, std::vector<section>& sections, const std::vector<parameter>& parameters, std::vector<double>& x)
+		{
+			const size_t n = parameters.size();
+			const size_t NP = ctx.population ? ctx.population : std::max<size_t>(10 * n, 16);
+			const double F = 0.7;
+			const double CR = 0.9;
+			
+			std::mt19937_64 rng(ctx.seed);
+			std::uniform_real_distribution<double> uniform(0.0, 1.0);
+			
+			std::vector<std::vector<double>> population(NP, std::vector<double>(n)), trial = population;
+			std::vector<double> cost(NP), trial_cost(NP);
+			std::map<std::vector<double>, double> cache;
+			
+			auto decode = [&](const std::vector<double>& v)
+			{
+				std::vector<section> s = sections;
+				apply(parameters, v, s);
+				return s;
+			};
+			
+			auto key = [&](const std::vector<section>& s)
+			{
+				std::vector<double> k;
+				k.reserve(n);
+				for (const auto& p : parameters)
+					k.push_back(s[p.index].*p.field);
+				return k;
+			};
+			
+			// Evaluates every candidate missing from the cache in parallel
+			auto evaluate = [&](const std::vector<std::vector<double>>& candidates, std::vector<double>& out)
+			{
+				std::vector<std::vector<section>> designs;
+				std::vector<std::vector<double>> keys;
+				std::map<std::vector<double>, size_t> pending;
+				
+				for (const auto& c : candidates)
+				{
+					auto s = decode(c);
+					auto k = key(s);
+					if (!cache.count(k) && !pending.count(k))
+					{
+						pending[k] = designs.size();
+						designs.push_back(std::move(s));
+						keys.push_back(std::move(k));
+					}
+				}
+				
+				std::vector<double> J(designs.size());
+				parallel_for(designs.size(), [&](size_t i, size_t)
+				{
+					J[i] = objective(ctx, designs[i]);
+				}, ctx.threads);
+				
+				for (size_t i = 0; i < designs.size(); ++i)
+					cache[keys[i]] = J[i];
+				
+				for (size_t i = 0; i < candidates.size(); ++i)
+					out[i] = cache[key(decode(candidates[i]))];
+			};
+			
+			size_t generation = 0;
+			
+			for (auto& v : population)
+				for (auto& c : v)
+					c = uniform(rng);
+			
+			// The centre of the design space seeds the population
+			population[0] = x;
+			
+			if (!ctx.checkpoint.empty())
+				generation = load_checkpoint(ctx.checkpoint, population, cost);
+			
+			if (generation)
+				std::cerr << "[INFO] optimize: resuming from generation " << generation << std::endl;
+			else
+				evaluate(population, cost);
+			
+			for (; generation < ctx.iterations; ++generation)
+			{
+				// Seeded per generation so a resumed run repeats the uninterrupted one
+				std::seed_seq seq{ctx.seed, static_cast<unsigned>(generation + 1)};
+				rng.seed(seq);
+				
+				for (size_t i = 0; i < NP; ++i)
+				{
+					size_t a, b, c;
+					do a = rng() % NP; while (a == i);
+					do b = rng() % NP; while (b == i || b == a);
+					do c = rng() % NP; while (c == i || c == a || c == b);
+					
+					const size_t forced = rng() % n;
+					
+					for (size_t j = 0; j < n; ++j)
+					{
+						if (j == forced || uniform(rng) < CR)
+						{
+							double v = population[a][j] + F * (population[b][j] - population[c][j]);
+							
+							// Bounce back into the box
+							if (v < 0.0) v = uniform(rng) * population[a][j];
+							if (v > 1.0) v = population[a][j] + uniform(rng) * (1.0 - population[a][j]);
+							trial[i][j] = v;
+						}
+						else
+							trial[i][j] = population[i][j];
+					}
+				}
+				
+				evaluate(trial, trial_cost);
+				
+				for (size_t i = 0; i < NP; ++i)
+				{
+					if (trial_cost[i] <= cost[i])
+					{
+						population[i] = trial[i];
+						cost[i] = trial_cost[i];
+					}
+				}
+				
+				const double best = *std::min_element(cost.begin(), cost.end());
+				std::cerr << "[INFO] optimize: generation " << generation << " objective " << best << std::endl;
+				
+				if (!ctx.checkpoint.empty())
+					save_checkpoint(ctx.checkpoint, generation + 1, population, cost);
+				
+				if (best == 0.0)
+					break;
+			}
+			
+			const size_t best = std::min_element(cost.begin(), cost.end()) - cost.begin();
+			x = population[best];
+			
+			return cost[best];
+		}
+	}
+
+	int 
+	optimize(const ctl& ctx)
+	{
+		std::vector<section> sections;
+		std::vector<parameter> parameters;
+		
+		design_space(ctx, sections, parameters, ctx.optimizer != LBFGS);
+		
+		if (parameters.empty())
+		{
+			std::cerr << "[ERROR] optimize: no free parameters, specify a range as <min>,<max>" << std::endl;
+			return -1;
+		}
+		
+		const size_t n = parameters.size();
+		std::vector<double> x(n);
+		
+		for (size_t i = 0; i < n; ++i)
+		{
+			const auto& p = parameters[i];
+			x[i] = (sections[p.index].*p.field - p.lower) / (p.upper - p.lower);
+		}
+		
+		double J = 0;
+		
+		if (ctx.optimizer == LBFGS)
+			J = minimize_lbfgs(ctx, sections, parameters, x);
+		else
+			J = minimize_de(ctx, sections, parameters, x);
+		
+		// Leave the sections at the optimum
+		apply(parameters, x, sections);
+		
+		bool sweep_width1 = !ctx.width1.empty();
+		bool sweep_width2 = !ctx.width2.empty();
+		
+		printf("section,period,duty_cycle,N");
+		if (sweep_width1) printf(",w1");
+		if (sweep_width2) printf(",w2");
+		printf("\n");
+		
+		for (size_t k = 0; k < sections.size(); ++k)
+		{
+			const auto& s = sections[k];
+			printf("%zu,%.6g,%.6g,%.6g", k, s.period, s.duty_cycle, s.N);
+			if (sweep_width1) printf(",%.6g", s.w1);
+			if (sweep_width2) printf(",%.6g", s.w2);
+			printf("\n");
+		}
+		
+		std::cerr << "[INFO] optimize: objective " << J << std::endl;
+		
+		return 0;
+	}
+}//namespace tmm
@@ -0,0 +1,122 @@
+/**
+ * \file pareto.cc
+ * \brief implementations for pareto.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <pareto.h>
+#include <sampling.h>
+#include <metrics.h>
+#include <bragg.h>
+#include <pool.h>
+#include <iostream>
+
+namespace tmm
+{
+	namespace
+	{
+		constexpr size_t block = 4096; ///< designs summarized in parallel between archive updates
+
+		/**
+		 * \brief Archived design and its summary
+		 */
+		struct candidate
+		{
+			design d; ///< The design
+			summary s; ///< Summary of its reflection spectrum
+		};
+	}
+
+	int 
+	pareto(const ctl& ctx)
+	{
+		const auto points = designs(ctx);
+		const size_t W = ctx.wavelengths.size();
+		
+		pareto_archive<4, candidate> archive;
+		std::vector<summary> summaries(block);
+		
+		for (size_t begin = 0; begin < points.size(); begin += block)
+		{
+			const size_t end = std::min(begin + block, points.size());
+			
+			parallel_for(end - begin, [&](size_t j, size_t)
+			{
+				const auto& [period, duty_cycle, N, w1, w2] = points[begin + j];
+				Bragg grating(period, duty_cycle, N);
+				std::vector<double> R(W);
+				
+				for (size_t idx = 0; idx < W; ++idx)
+				{
+					const double wavelength = ctx.wavelengths[idx];
+					R[idx] = std::get<0>(grating.scattering_coefficients(
+						wavelength,
+						(*ctx.n1)(wavelength, w1, idx), 
+						(*ctx.n2)(wavelength, w2, idx), 
+						(*ctx.loss)(wavelength, 0.0, idx),
+						false));
+				}
+				
+				summaries[j] = summarize(ctx.wavelengths, R);
+			}, ctx.threads);
+			
+			// Archive updates in design order keep the front independent of the thread count
+			for (size_t j = 0; j < end - begin; ++j)
+			{
+				const auto& d = points[begin + j];
+				const auto& s = summaries[j];
+				archive.insert({-s.peak, -s.bandwidth, d.N * d.period, s.sidelobe}, {d, s});
+			}
+		}
+		
+		std::vector<candidate> front;
+		archive.for_each([&](const auto&, const candidate& c) { front.push_back(c); });
+		std::sort(front.begin(), front.end(), [](const candidate& a, const candidate& b)
+		{
+			return a.s.peak != b.s.peak ? a.s.peak > b.s.peak : a.d.N * a.d.period < b.d.N * b.d.period;
+		});
+		
+		std::cerr << "[INFO] pareto: " << points.size() << " designs, front of " << front.size() << std::endl;
+		
+		bool sweep_width1 = !ctx.width1.empty();
+		bool sweep_width2 = !ctx.width2.empty();
+		
+		printf("period,duty_cycle,N");
+		if (sweep_width1) printf(",w1");
+		if (sweep_width2) printf(",w2");
+		printf(",length,peak_R,peak_wavelength,bandwidth,sidelobe\n");
+		
+		for (const auto& [d, s] : front)
+		{
+			printf("%.6g,%.6g,%.6g", d.period, d.duty_cycle, d.N);
+			if (sweep_width1) printf(",%.6g", d.w1);
+			if (sweep_width2) printf(",%.6g", d.w2);
+			printf(",%.6g,%.6g,%.6g,%.6g,%.6g\n", d.N * d.period, s.peak, s.center, s.bandwidth, s.sidelobe);
+		}
+		
+		return 0;
+	}
+}//namespace tmm
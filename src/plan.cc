@@ -0,0 +1,329 @@
+/**
+ * \file plan.cc
+ * \brief cost-based planner of Bragg sweeps
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <plan.h>
+#include <batch.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace tmm
+{
+	namespace
+	{
+		// Costs of the kernel operations in ns, measured on the reference build
+		constexpr double c_direct = 90; ///< layer exponentials and closed-form period matrix
+		constexpr double c_recurrence = 40; ///< recurrent layer phases and closed-form period matrix
+		constexpr double c_cached = 10; ///< period matrix read from the cache
+		constexpr double c_layered = 650; ///< period matrix as the product of its layers
+		constexpr double c_binary = 150, c_binary_bit = 50; ///< matrix_power, fixed and per bit of N
+		constexpr double c_chebyshev = 250; ///< chebyshev_power
+		constexpr double c_coefficients = 30; ///< R, T and phases of the N-period matrix
+		constexpr double c_sparameters = 60; ///< S-parameters of the N-period matrix
+		constexpr double c_batch = 415, c_batch_bit = 36; ///< batch_coefficients, fixed and per bit of N
+		constexpr double c_lookup = 2; ///< material table read
+		constexpr double c_model = 4, c_term = 20; ///< material model, fixed and per Taylor term
+		constexpr double c_field = 250; ///< formatted output field
+
+		constexpr size_t table_limit = size_t(1) << 24; ///< largest material table, entries
+		constexpr size_t cache_limit = size_t(1) << 22; ///< largest period-matrix cache, matrices
+		constexpr size_t sample_groups = 512; ///< batches of consecutive designs costed by the planner
+
+		/**
+		 * \brief Bits of the binary expansion of N
+		 */
+		double bits(double N)
+		{
+			return std::bit_width(static_cast<uint64_t>(N));
+		}
+
+		/**
+		 * \brief Evaluation cost of a material model, ns
+		 */
+		double model_cost(const cml& model)
+		{
+			size_t terms = 0;
+			if (model.wavelength_model)
+				terms += model.wavelength_model->coeffs.size() - 1;
+			if (model.width_model)
+				terms += model.width_model->coeffs.size() - 1;
+			
+			return c_model + c_term * terms;
+		}
+
+		/**
+		 * \brief Distinct widths of the design points a model depends on, sorted
+		 */
+		std::vector<double> distinct_widths(const cml& model, const design_set& points, double design::* width)
+		{
+			if (!width || !model.width_model)
+				return {0.0};
+			
+			return points.distinct(width);
+		}
+
+		/**
+		 * \brief Non-dispersive material, a constant or a function of width only
+		 */
+		bool dispersive(const cml& model)
+		{
+			return model.sampled || model.wavelength_model;
+		}
+
+		/**
+		 * \brief Period matrices held by the cache of the N axis, 0 when not applicable
+		 */
+		size_t cache_size(const ctl& ctx)
+		{
+			if (ctx.sampling != CARTESIAN || ctx.Ns.size() < 2)
+				return 0;
+			
+			return std::max<size_t>(ctx.width1.size(), 1) * std::max<size_t>(ctx.width2.size(), 1) * ctx.wavelengths.size();
+		}
+
+		const char* material_names[] = {"n1", "n2", "loss"};
+		double design::* const material_widths[] = {&design::w1, &design::w2, nullptr};
+	}
+
+	bool recurrent(const ctl& ctx, const wavenumber_grid& grid, const design& d)
+	{
+		return grid.deviation * std::max((*ctx.n1)(0.0, d.w1), (*ctx.n2)(0.0, d.w2)) * d.period <= 1e-4;
+	}
+
+	sweep_plan plan_sweep(const ctl& ctx, const design_set& points)
+	{
+		sweep_plan plan;
+		const size_t D = points.size(), K = ctx.wavelengths.size();
+		const double P = static_cast<double>(D) * K;
+		const cml* models[] = {ctx.n1.get(), ctx.n2.get(), ctx.loss.get()};
+		
+		const bool group_delay = ctx.dl && (ctx.columns & COL_GROUP_DELAY);
+		const bool batch = ctx.sparameters == SP_NONE && ctx.linewidth == 0 && !group_delay;
+		
+		// Materials are tabulated when building the table costs less than the evaluations it replaces
+		double material[2] = {}; // per point, one and two evaluations per material
+		for (size_t m = 0; m < 3; ++m)
+		{
+			const double cost = model_cost(*models[m]);
+			const size_t rows = distinct_widths(*models[m], points, material_widths[m]).size();
+			
+			plan.tables[m] = (models[m]->wavelength_model || models[m]->width_model) 
+				&& rows * K <= table_limit && rows * cost < D * (cost - c_lookup);
+			
+			material[0] += plan.tables[m] ? c_lookup : cost;
+			material[1] += 2 * (plan.tables[m] ? c_lookup : cost);
+		}
+		
+		// Per-design costs from evenly spaced batches of consecutive designs, scaled to the sweep
+		const size_t W = batch_lanes;
+		const size_t groups = (D + W - 1) / W, sampled = std::min(groups, sample_groups);
+		const bool recurrence = ctx.linewidth == 0 && K >= 16 
+			&& !dispersive(*ctx.n1) && !dispersive(*ctx.n2) && !dispersive(*ctx.loss);
+		const auto grid = recurrence ? uniform_wavenumber(ctx.wavelengths) : wavenumber_grid{};
+		
+		double binary_mean = 0, wavelength_major = 0, design_major = 0, recurrent_fraction = 0;
+		size_t count = 0;
+		for (size_t s = 0; s < sampled; ++s)
+		{
+			const size_t begin = s * groups / sampled * W, end = std::min(begin + W, D);
+			double largest = 0;
+			for (size_t j = begin; j < end; ++j)
+			{
+				const design d = points[j];
+				binary_mean += c_binary + c_binary_bit * bits(d.N);
+				wavelength_major += ((K + W - 1) / W) * (c_batch + c_batch_bit * bits(d.N));
+				recurrent_fraction += recurrence && recurrent(ctx, grid, d);
+				largest = std::max(largest, d.N);
+			}
+			design_major += (((end - begin) * K + W - 1) / W) * (c_batch + c_batch_bit * bits(largest));
+			count += end - begin;
+		}
+		if (count)
+		{
+			binary_mean /= count;
+			wavelength_major *= static_cast<double>(D) / count;
+			recurrent_fraction /= count;
+			design_major *= static_cast<double>(groups) / sampled;
+		}
+		
+		// Costs shared by every plan: group delay, line shape averaging and output
+		double fixed = 0;
+		
+		if (group_delay)
+			fixed += P * 2 * (c_layered + binary_mean + c_coefficients + model_cost(*ctx.n1) + model_cost(*ctx.n2));
+		
+		if (ctx.linewidth > 0)
+			fixed += P * (c_layered + binary_mean + c_coefficients + material[0]);
+		
+		const size_t fields = 4 + !ctx.width1.empty() + !ctx.width2.empty() 
+			+ std::popcount(static_cast<unsigned>(group_delay ? ctx.columns : ctx.columns & ~COL_GROUP_DELAY)) 
+			+ (ctx.sparameters == SP_NONE ? 0 : 8);
+		plan.output = P * fields * c_field * 1e-9;
+		
+		struct option
+		{
+			sweep_plan plan;
+			double cost;
+		};
+		std::vector<option> options;
+		
+		if (batch)
+		{
+			// Wavelength-major batches of every design, and design-major batches sharing the bits of their largest N
+			sweep_plan p = plan;
+			p.kernel = KERNEL_BATCH;
+			p.packing = PACK_WAVELENGTH;
+			options.push_back({p, wavelength_major + P * material[1]});
+			p.packing = PACK_DESIGN;
+			options.push_back({p, design_major + P * material[1]});
+		}
+		
+		// Scalar kernels
+		const size_t cache = cache_size(ctx);
+		const double extract = ctx.sparameters == SP_NONE ? c_coefficients : c_sparameters;
+		
+		for (power_t power : {POWER_BINARY, POWER_CHEBYSHEV})
+			for (phase_t phase : {PHASE_DIRECT, PHASE_RECURRENCE})
+				for (bool period_cache : {false, true})
+				{
+					if ((phase == PHASE_RECURRENCE && !(recurrence && recurrent_fraction > 0)) 
+						|| (period_cache && !(cache && cache <= cache_limit)))
+						continue;
+					
+					double phases = phase == PHASE_RECURRENCE 
+						? recurrent_fraction * c_recurrence + (1 - recurrent_fraction) * c_direct 
+						: c_direct;
+					if (period_cache)
+						phases = (phases + (ctx.Ns.size() - 1) * c_cached) / ctx.Ns.size();
+					
+					sweep_plan p = plan;
+					p.kernel = KERNEL_SCALAR;
+					p.power = power;
+					p.phase = phase;
+					p.period_cache = period_cache;
+					options.push_back({p, 
+						P * (phases + (power == POWER_BINARY ? binary_mean : c_chebyshev) + extract + material[0])});
+				}
+		
+		std::stable_sort(options.begin(), options.end(), [](const auto& a, const auto& b) { return a.cost < b.cost; });
+		
+		for (const auto& [p, cost] : options)
+		{
+			std::string name;
+			if (p.kernel == KERNEL_BATCH)
+				name = p.packing == PACK_DESIGN ? "batch, design-major" : "batch, wavelength-major";
+			else
+			{
+				name = "scalar, ";
+				name += p.power == POWER_CHEBYSHEV ? "chebyshev power" : "binary power";
+				name += p.phase == PHASE_RECURRENCE ? ", recurrent phases" : ", direct phases";
+				if (p.period_cache)
+					name += ", period cache";
+			}
+			plan.candidates.push_back({name, (cost + fixed) * 1e-9});
+		}
+		
+		const auto& best = options.front().plan;
+		plan.kernel = best.kernel;
+		plan.packing = best.packing;
+		plan.power = best.power;
+		plan.phase = best.phase;
+		plan.period_cache = best.period_cache;
+		plan.evaluation = plan.candidates.front().cost;
+		
+		return plan;
+	}
+
+	void explain(const ctl& ctx, const design_set& points, const sweep_plan& plan, FILE* out)
+	{
+		const cml* models[] = {ctx.n1.get(), ctx.n2.get(), ctx.loss.get()};
+		
+		fprintf(out, "sweep: %zu designs x %zu wavelengths\n", points.size(), ctx.wavelengths.size());
+		
+		if (plan.kernel == KERNEL_BATCH)
+		{
+			fprintf(out, "kernel: batch of %zu lanes, %s\n", batch_lanes, plan.packing == PACK_DESIGN 
+				? "design-major, one wavelength of consecutive designs per batch" 
+				: "wavelength-major, consecutive wavelengths of one design per batch");
+			fprintf(out, "power: binary, masked per lane\n");
+			fprintf(out, "phases: direct\n");
+		}
+		else
+		{
+			fprintf(out, "kernel: scalar\n");
+			fprintf(out, "power: %s\n", plan.power == POWER_CHEBYSHEV 
+				? "chebyshev, closed form, binary at the band edges" : "binary");
+			fprintf(out, "phases: %s\n", plan.phase == PHASE_RECURRENCE 
+				? "recurrence on the uniform wave-number grid" : "direct");
+		}
+		
+		if (plan.period_cache)
+			fprintf(out, "period cache: %zu matrices, reused by every N after the first\n", cache_size(ctx));
+		else
+			fprintf(out, "period cache: none\n");
+		
+		fprintf(out, "tables:");
+		bool any = false;
+		for (size_t m = 0; m < 3; ++m)
+			if (plan.tables[m])
+			{
+				fprintf(out, "%s %s %zu x %zu", any ? "," : "", material_names[m], 
+					distinct_widths(*models[m], points, material_widths[m]).size(), ctx.wavelengths.size());
+				any = true;
+			}
+		fprintf(out, "%s\n", any ? "" : " none");
+		
+		fprintf(out, "estimate: %.3g s evaluation, %.3g s output\n", plan.evaluation, plan.output);
+		fprintf(out, "candidates:\n");
+		for (size_t j = 0; j < plan.candidates.size(); ++j)
+			fprintf(out, "  %10.3g s  %s%s\n", plan.candidates[j].cost, plan.candidates[j].name.c_str(), j ? "" : "  (chosen)");
+	}
+
+	material::material(const cml& model, const std::vector<double>& wavelengths, const design_set& points, 
+		double design::* width, bool tabulate) : 
+	_model(model), _wavelengths(wavelengths), _width(width)
+	{
+		if (!tabulate)
+			return;
+		
+		_widths = distinct_widths(model, points, width);
+		_values.resize(_widths.size() * wavelengths.size());
+		for (size_t j = 0; j < _widths.size(); ++j)
+			for (size_t k = 0; k < wavelengths.size(); ++k)
+				_values[j * wavelengths.size() + k] = model(wavelengths[k], _widths[j], k);
+	}
+
+	size_t material::row(const design& d) const
+	{
+		if (_widths.size() < 2)
+			return 0;
+		
+		return std::lower_bound(_widths.begin(), _widths.end(), d.*_width) - _widths.begin();
+	}
+}//namespace tmm
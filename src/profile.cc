@@ -0,0 +1,315 @@
+/**
+ * \file profile.cc
+ * \brief implementations for profile.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <profile.h>
+#include <mapping.h>
+#include <pool.h>
+#include <map>
+#include <charconv>
+#include <cstring>
+
+namespace tmm
+{
+	namespace
+	{
+		static constexpr size_t min_chunk = 256; ///< segments per product chunk before threading pays off
+
+		/**
+		 * \brief C = A * B, C may alias A or B
+		 */
+		void multiply(std::complex<double>** A, std::complex<double>** B, std::complex<double>** C)
+		{
+			auto work = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			damm::zeros<std::complex<double>, damm::NONE>(work.get(), 2, 2);
+			damm::multiply<std::complex<double>, damm::NONE>(A, B, work.get(), 2, 2, 2);
+			for (size_t i = 0; i < 2; ++i)
+				for (size_t j = 0; j < 2; ++j)
+					C[i][j] = work[i][j];
+		}
+
+		/**
+		 * \brief Parse "length,n,loss" lines
+		 */
+		void parse_text(const char* p, const char* end, std::vector<layer>& layers)
+		{
+			while (p < end)
+			{
+				const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+				if (!eol)
+					eol = end;
+				
+				double v[3];
+				const char* q = p;
+				size_t k = 0;
+				for (; k < 3; ++k)
+				{
+					while (q < eol && (*q == ' ' || *q == '\t' || (k && *q == ',')))
+						++q;
+					auto [next, ec] = std::from_chars(q, eol, v[k]);
+					if (ec != std::errc())
+						break;
+					q = next;
+				}
+				
+				if (k == 3)
+					layers.push_back({v[0], v[1], v[2]});
+				
+				p = eol + 1;
+			}
+		}
+	}
+
+	Profile::Profile(const std::string& path, size_t max_group)
+	{
+		std::vector<layer> layers;
+		{
+			mapping file(path);
+			
+			if (file.size() && is_text(file.data(), file.size()))
+				parse_text(file.data(), file.data() + file.size(), layers);
+			else
+			{
+				if (file.size() % sizeof(layer))
+					throw std::runtime_error("truncated layer record in " + path);
+				layers.resize(file.size() / sizeof(layer));
+				std::memcpy(layers.data(), file.data(), file.size());
+			}
+		}
+		
+		if (layers.empty())
+			throw std::runtime_error("no layers in " + path);
+		
+		_layers = layers.size();
+		compress(layers, std::max<size_t>(max_group, 1));
+	}
+
+	void 
+	Profile::compress(const std::vector<layer>& layers, size_t max_group)
+	{
+		const size_t L = layers.size();
+		
+		// Hash-cons the unit elements, a layer followed by the step into the next layer
+		std::vector<uint32_t> s(L);
+		{
+			std::map<std::array<double, 4>, uint32_t> table;
+			for (size_t i = 0; i < L; ++i)
+			{
+				const double next = layers[(i + 1) % L].n;
+				std::array<double, 4> key{layers[i].length, layers[i].n, layers[i].loss, next};
+				auto [it, inserted] = table.emplace(key, _elements.size());
+				if (inserted)
+					_elements.push_back(key);
+				s[i] = it->second;
+			}
+		}
+		
+		std::map<std::vector<uint32_t>, uint32_t> groups;
+		std::map<std::pair<uint32_t, uint64_t>, uint32_t> powers;
+		
+		auto emit = [&](size_t begin, size_t length, uint64_t count)
+		{
+			std::vector<uint32_t> g(s.begin() + begin, s.begin() + begin + length);
+			auto [git, ginserted] = groups.emplace(std::move(g), _groups.size());
+			if (ginserted)
+				_groups.push_back(git->first);
+			
+			auto [pit, pinserted] = powers.emplace(std::make_pair(git->second, count), _powers.size());
+			if (pinserted)
+				_powers.push_back({git->second, count});
+			
+			_segments.push_back(pit->second);
+		};
+		
+		// Greedy parse: at each position take the group length whose run covers the most layers
+		size_t literal = 0, i = 0;
+		while (i < L)
+		{
+			size_t best = 0;
+			uint64_t best_count = 0;
+			
+			for (size_t p = 1; p <= max_group && i + 2 * p <= L; ++p)
+			{
+				// Multiples of a repeating group cover no more layers than the group itself
+				if (s[i + p] != s[i] || (best && p % best == 0))
+					continue;
+				
+				uint64_t count = 1;
+				while (i + (count + 1) * p <= L 
+					&& std::equal(s.begin() + i, s.begin() + i + p, s.begin() + i + count * p))
+					count++;
+				
+				if (count >= 2 && count * p > best_count * best)
+				{
+					best = p;
+					best_count = count;
+				}
+			}
+			
+			if (best == 0)
+			{
+				// Literal layers are packed into groups of max_group
+				if (++literal == max_group)
+				{
+					emit(i + 1 - literal, literal, 1);
+					literal = 0;
+				}
+				i++;
+				continue;
+			}
+			
+			if (literal)
+				emit(i - literal, literal, 1);
+			literal = 0;
+			
+			emit(i, best, best_count);
+			i += best * best_count;
+		}
+		
+		if (literal)
+			emit(L - literal, literal, 1);
+	}
+
+	double 
+	Profile::product(std::complex<double>** T, double wavelength, size_t threads)
+	{
+		const size_t E = _elements.size();
+		const size_t G = _groups.size();
+		const size_t P = _powers.size();
+		const size_t S = _segments.size();
+		
+		// Unit element matrices
+		auto elements = damm::aligned_alloc_2D<std::complex<double>, 64>(2 * E, 2);
+		parallel_for(E, [&](size_t e, size_t)
+		{
+			const auto& [length, n, loss, next] = _elements[e];
+			auto P_ = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			auto S_ = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			
+			homogeneous_layer(P_.get(), wavelength, length, n, loss);
+			index_step(S_.get(), n, next);
+			
+			damm::zeros<std::complex<double>, damm::NONE>(elements.get() + 2 * e, 2, 2);
+			damm::multiply<std::complex<double>, damm::NONE>(P_.get(), S_.get(), elements.get() + 2 * e, 2, 2, 2);
+		}, E > min_chunk ? threads : 1);
+		
+		// Group matrices
+		auto groups = damm::aligned_alloc_2D<std::complex<double>, 64>(2 * G, 2);
+		std::vector<double> group_log(G, 0.0);
+		parallel_for(G, [&](size_t g, size_t)
+		{
+			std::complex<double>** acc = groups.get() + 2 * g;
+			damm::identity<std::complex<double>, damm::NONE>(acc, 2, 2);
+			for (auto e : _groups[g])
+			{
+				multiply(acc, elements.get() + 2 * e, acc);
+				normalize(acc, group_log[g]);
+			}
+		}, G > min_chunk ? threads : 1);
+		
+		// Powers of groups
+		auto powers = damm::aligned_alloc_2D<std::complex<double>, 64>(2 * P, 2);
+		std::vector<double> power_log(P, 0.0);
+		parallel_for(P, [&](size_t k, size_t)
+		{
+			const auto& [g, count] = _powers[k];
+			power_log[k] = scaled_power(groups.get() + 2 * g, powers.get() + 2 * k, count) + count * group_log[g];
+		}, P > min_chunk ? threads : 1);
+		
+		// Each chunk multiplies a contiguous run of segments, chunk products are combined in order
+		const size_t chunks = std::max<size_t>(1, std::min(concurrency(threads) * 4, S / min_chunk));
+		auto partial = damm::aligned_alloc_2D<std::complex<double>, 64>(2 * chunks, 2);
+		std::vector<double> log_scale(chunks, 0.0);
+		
+		parallel_for(chunks, [&](size_t c, size_t)
+		{
+			std::complex<double>** acc = partial.get() + 2 * c;
+			damm::identity<std::complex<double>, damm::NONE>(acc, 2, 2);
+			
+			for (size_t k = c * S / chunks; k < (c + 1) * S / chunks; ++k)
+			{
+				multiply(acc, powers.get() + 2 * _segments[k], acc);
+				log_scale[c] += power_log[_segments[k]];
+				normalize(acc, log_scale[c]);
+			}
+		}, chunks > 1 ? threads : 1);
+		
+		// Pairwise tree over the chunk products
+		for (size_t stride = 1; stride < chunks; stride *= 2)
+		{
+			for (size_t c = 0; c + stride < chunks; c += 2 * stride)
+			{
+				multiply(partial.get() + 2 * c, partial.get() + 2 * (c + stride), partial.get() + 2 * c);
+				log_scale[c] += log_scale[c + stride];
+				normalize(partial.get() + 2 * c, log_scale[c]);
+			}
+		}
+		
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				T[i][j] = partial[i][j];
+		
+		return log_scale[0];
+	}
+
+	void 
+	Profile::scattering_matrix(std::complex<double>** T, double wavelength, size_t threads)
+	{
+		const double scale = std::exp(product(T, wavelength, threads));
+		
+		for (size_t i = 0; i < 2; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				T[i][j] *= scale;
+	}
+
+	std::tuple<double, double, double, double>
+	Profile::scattering_coefficients(double wavelength, size_t threads)
+	{
+		auto sparams = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		
+		// R and the phases are scale invariant, T carries the scale
+		const double scale = product(sparams.get(), wavelength, threads);
+
+		double R, T, r, t;
+
+		tmm::scattering_coefficients(sparams.get(), R, T, r, t);
+		T *= std::exp(-2.0 * scale);
+
+		return std::make_tuple(R, T, r, t);
+	}
+
+	sparameters
+	Profile::scattering_parameters(double wavelength, size_t threads)
+	{
+		auto M = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		
+		const double scale = product(M.get(), wavelength, threads);
+
+		return tmm::scattering_parameters(M.get(), scale);
+	}
+}//namespace tmm
@@ -0,0 +1,163 @@
+/**
+ * \file pulse.cc
+ * \brief implementations for pulse.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <pulse.h>
+#include <bragg.h>
+#include <fft.h>
+#include <pool.h>
+#include <iostream>
+#include <algorithm>
+#include <numbers>
+
+namespace tmm
+{
+	namespace
+	{
+		constexpr double tukey_taper = 0.25; ///< tapered fraction of the Tukey window
+
+		/**
+		 * \brief Spectral window over M samples
+		 */
+		double window(window_t type, size_t k, size_t M)
+		{
+			const double x = M > 1 ? static_cast<double>(k) / (M - 1) : 0.5;
+			switch (type)
+			{
+				case WINDOW_HANN:
+					return 0.5 * (1.0 - std::cos(2.0 * std::numbers::pi * x));
+				case WINDOW_TUKEY:
+				{
+					const double edge = std::min(x, 1.0 - x);
+					if (edge >= 0.5 * tukey_taper)
+						return 1.0;
+					return 0.5 * (1.0 - std::cos(2.0 * std::numbers::pi * edge / tukey_taper));
+				}
+				default:
+					return 1.0;
+			}
+		}
+
+		/**
+		 * \brief Energy and centroid delay of a sampled envelope
+		 */
+		std::pair<double, double> moments(const std::vector<std::complex<double>>& e, double dt)
+		{
+			const size_t L = e.size();
+			double energy = 0, first = 0;
+			for (size_t j = 0; j < L; ++j)
+			{
+				const double t = (j < L / 2 ? static_cast<double>(j) : static_cast<double>(j) - L) * dt;
+				energy += std::norm(e[j]);
+				first += t * std::norm(e[j]);
+			}
+			return {energy, energy > 0 ? first / energy : 0.0};
+		}
+	}
+
+	int 
+	pulse(const ctl& ctx)
+	{
+		const double period = ctx.periods[0];
+		const double duty_cycle = ctx.duty_cycles[0];
+		const double N = ctx.Ns[0];
+		const double w1 = ctx.width1.empty() ? 0.0 : ctx.width1[0];
+		const double w2 = ctx.width2.empty() ? 0.0 : ctx.width2[0];
+		
+		const auto [lmin, lmax] = std::minmax_element(ctx.wavelengths.begin(), ctx.wavelengths.end());
+		const double nu_lo = c_um_ps / *lmax, nu_hi = c_um_ps / *lmin;
+		
+		// Uniform frequency grid, periodic over M samples, padded to L in time
+		const size_t M = next_pow2(ctx.fft_size);
+		const size_t L = M * next_pow2(ctx.pad);
+		const double dnu = (nu_hi - nu_lo) / M;
+		const double dt = 1.0 / (L * dnu);
+		
+		const double nu_carrier = ctx.carrier > 0 ? c_um_ps / ctx.carrier : 0.5 * (nu_lo + nu_hi);
+		const size_t kc = static_cast<size_t>(std::clamp(std::floor((nu_carrier - nu_lo) / dnu + 0.5), 0.0, M - 1.0));
+		
+		// Gaussian pulse of intensity FWHM tau: |E(t)|^2 ~ exp(-4 ln2 t^2/tau^2)
+		const double tau = ctx.pulse_width;
+		const double spread = std::numbers::pi * std::numbers::pi * tau * tau / (2.0 * std::numbers::ln2);
+		
+		std::vector<std::complex<double>> input(L), reflected(L), transmitted(L);
+		
+		Bragg grating(period, duty_cycle, N);
+		parallel_for(M, [&](size_t k, size_t)
+		{
+			const double nu = nu_lo + k * dnu;
+			const double wavelength = c_um_ps / nu;
+			const double f = (static_cast<double>(k) - static_cast<double>(kc)) * dnu;
+			
+			const auto S = grating.scattering_parameters(wavelength, 
+				(*ctx.n1)(wavelength, w1), 
+				(*ctx.n2)(wavelength, w2), 
+				(*ctx.loss)(wavelength, 0.0));
+			
+			const double E = std::exp(-spread * f * f) * window(ctx.window, k, M);
+			const size_t bin = (k + L - kc) % L;
+			input[bin] = E;
+			reflected[bin] = E * S.S11;
+			transmitted[bin] = E * S.S21;
+		}, ctx.threads);
+		
+		// Layers propagate as exp(-i beta z) in t = 1/M00, i.e. fields go as exp(i omega t)
+		fft(input, true);
+		fft(reflected, true);
+		fft(transmitted, true);
+		
+		double peak = 0;
+		for (const auto& x : input)
+			peak = std::max(peak, std::abs(x));
+		
+		for (auto* e : {&input, &reflected, &transmitted})
+			for (auto& x : *e)
+				x /= peak;
+		
+		const auto [Ein, tin] = moments(input, dt);
+		const auto [Er, tr] = moments(reflected, dt);
+		const auto [Et, tt] = moments(transmitted, dt);
+		std::cerr << "[INFO] pulse: carrier " << c_um_ps / (nu_lo + kc * dnu) << " um, time step " << dt 
+			<< " ps, window " << L * dt << " ps" << std::endl;
+		std::cerr << "[INFO] pulse: reflected energy " << Er / Ein << " delay " << tr - tin 
+			<< " ps, transmitted energy " << Et / Ein << " delay " << tt - tin << " ps" << std::endl;
+		
+		printf("time,input,reflected,transmitted,reflected_phase,transmitted_phase\n");
+		for (size_t i = 0; i < L; ++i)
+		{
+			// Centred time axis, negative times wrap to the end of the transform
+			const size_t j = (i + L / 2) % L;
+			const double t = (static_cast<double>(i) - static_cast<double>(L / 2)) * dt;
+			printf("%.6g,%.6g,%.6g,%.6g,%.6g,%.6g\n", t, 
+				std::norm(input[j]), std::norm(reflected[j]), std::norm(transmitted[j]), 
+				std::arg(reflected[j]), std::arg(transmitted[j]));
+		}
+		
+		return 0;
+	}
+}//namespace tmm
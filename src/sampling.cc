@@ -0,0 +1,221 @@
+/**
+ * \file sampling.cc
+ * \brief implementations for sampling.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <sampling.h>
+#include <rng.h>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <bit>
+#include <cmath>
+
+namespace tmm
+{
+	namespace
+	{
+		/**
+		 * \brief Primitive polynomial and initial direction numbers of a Sobol dimension (Joe-Kuo)
+		 */
+		struct direction
+		{
+			unsigned degree; ///< Degree s of the primitive polynomial
+			unsigned a; ///< Interior coefficients of the polynomial
+			unsigned m[4]; ///< Initial direction numbers m_1..m_s
+		};
+
+		// The first dimension is the van der Corput sequence, one entry per remaining axis
+		constexpr direction directions[] = 
+		{
+			{1, 0, {1}},
+			{2, 1, {1, 3}},
+			{3, 1, {1, 3, 1}},
+			{3, 2, {1, 1, 1}},
+		};
+
+		constexpr size_t bits = 32;
+
+		/**
+		 * \brief Direction numbers v_k = m_k 2^(32-k) of Sobol dimension `dimension`
+		 */
+		std::array<uint32_t, bits> 
+		direction_numbers(size_t dimension)
+		{
+			std::array<uint32_t, bits> v{};
+			
+			if (dimension == 0)
+			{
+				for (size_t k = 0; k < bits; ++k)
+					v[k] = 1u << (bits - 1 - k);
+				return v;
+			}
+			
+			const auto& d = directions[dimension - 1];
+			for (size_t k = 0; k < d.degree; ++k)
+				v[k] = d.m[k] << (bits - 1 - k);
+			
+			for (size_t k = d.degree; k < bits; ++k)
+			{
+				v[k] = v[k - d.degree] ^ (v[k - d.degree] >> d.degree);
+				for (size_t j = 1; j < d.degree; ++j)
+					if ((d.a >> (d.degree - 1 - j)) & 1)
+						v[k] ^= v[k - j];
+			}
+			return v;
+		}
+
+		/**
+		 * \brief K Sobol points in [0, 1)^D, Gray code order, with a random digital shift per dimension
+		 */
+		std::vector<std::vector<double>> 
+		sobol(size_t K, size_t D, unsigned seed)
+		{
+			const philox rng(seed);
+			std::vector<std::vector<double>> points(K, std::vector<double>(D));
+			
+			for (size_t d = 0; d < D; ++d)
+			{
+				const auto v = direction_numbers(d);
+				const uint32_t shift = rng({0, 0, static_cast<uint32_t>(d), 0})[0];
+				
+				uint32_t x = 0;
+				for (size_t i = 0; i < K; ++i)
+				{
+					points[i][d] = (x ^ shift) * 0x1p-32;
+					// The next point flips the direction number of the lowest zero bit of i
+					x ^= v[std::countr_one(i)];
+				}
+			}
+			return points;
+		}
+
+		/**
+		 * \brief K Latin hypercube points in [0, 1)^D
+		 */
+		std::vector<std::vector<double>> 
+		latin_hypercube(size_t K, size_t D, unsigned seed)
+		{
+			const philox rng(seed);
+			std::vector<std::vector<double>> points(K, std::vector<double>(D));
+			std::vector<size_t> strata(K);
+			
+			for (size_t d = 0; d < D; ++d)
+			{
+				std::seed_seq seq{seed, static_cast<unsigned>(d)};
+				std::mt19937_64 engine(seq);
+				std::iota(strata.begin(), strata.end(), 0);
+				std::shuffle(strata.begin(), strata.end(), engine);
+				
+				for (size_t i = 0; i < K; ++i)
+					points[i][d] = (strata[i] + rng.uniform(i, d)[0]) / K;
+			}
+			return points;
+		}
+	}
+
+	design_set::design_set(const ctl& ctx) : 
+	_period(ctx.periods), _duty_cycle(ctx.duty_cycles), _N(ctx.Ns), 
+	_w1(!ctx.width1.empty() ? ctx.width1 : std::vector<double>{0.0}), 
+	_w2(!ctx.width2.empty() ? ctx.width2 : std::vector<double>{0.0}), 
+	_cartesian(ctx.sampling == CARTESIAN)
+	{
+		if (_cartesian)
+		{
+			_size = _period.size() * _duty_cycle.size() * _N.size() * _w1.size() * _w2.size();
+			return;
+		}
+		
+		// Sampled axes in the order of the cartesian loops
+		struct axis
+		{
+			double design::* field;
+			const std::vector<double>* values;
+		};
+		
+		const axis axes[] = 
+		{
+			{&design::period, &_period},
+			{&design::duty_cycle, &_duty_cycle},
+			{&design::N, &_N},
+			{&design::w1, &_w1},
+			{&design::w2, &_w2},
+		};
+		
+		design nominal{_period[0], _duty_cycle[0], _N[0], _w1[0], _w2[0]};
+		
+		std::vector<axis> sampled;
+		for (const auto& a : axes)
+			if (a.values->size() > 1)
+				sampled.push_back(a);
+		
+		const size_t K = ctx.samples;
+		const size_t D = sampled.size();
+		
+		auto points = ctx.sampling == SOBOL ? sobol(K, D, ctx.seed) : latin_hypercube(K, D, ctx.seed);
+		
+		_points.assign(K, nominal);
+		for (size_t i = 0; i < K; ++i)
+		{
+			for (size_t d = 0; d < D; ++d)
+			{
+				const auto [lo, hi] = std::minmax_element(sampled[d].values->begin(), sampled[d].values->end());
+				double value = *lo + (*hi - *lo) * points[i][d];
+				
+				if (sampled[d].field == &design::N)
+					value = std::round(value);
+				
+				_points[i].*sampled[d].field = value;
+			}
+		}
+		_size = K;
+	}
+
+	std::vector<double> 
+	design_set::distinct(double design::* field) const
+	{
+		std::vector<double> values;
+		if (_cartesian)
+		{
+			const std::vector<double>* axes[] = {&_period, &_duty_cycle, &_N, &_w1, &_w2};
+			double design::* const fields[] = {&design::period, &design::duty_cycle, &design::N, &design::w1, &design::w2};
+			for (size_t a = 0; a < 5; ++a)
+				if (fields[a] == field)
+					values = *axes[a];
+		}
+		else
+		{
+			values.reserve(_points.size());
+			for (const auto& d : _points)
+				values.push_back(d.*field);
+		}
+		
+		std::sort(values.begin(), values.end());
+		values.erase(std::unique(values.begin(), values.end()), values.end());
+		return values;
+	}
+}//namespace tmm
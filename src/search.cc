@@ -0,0 +1,372 @@
+/**
+ * \file search.cc
+ * \brief implementations for search.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <search.h>
+#include <optimize.h>
+#include <pool.h>
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <cmath>
+
+namespace tmm
+{
+	namespace
+	{
+		/**
+		 * \brief Searched axis of the design space
+		 */
+		struct axis
+		{
+			double section::* field; ///< design parameter
+			double lower; ///< lower bound
+			double upper; ///< upper bound
+		};
+
+		/**
+		 * \brief Hypercube of the search lattice
+		 */
+		struct cell
+		{
+			std::vector<uint64_t> origin; ///< lattice coordinates of the lower corner
+			uint64_t size; ///< edge length in lattice units
+		};
+
+		/**
+		 * \brief Upper estimate of the reflection of any grating with up to N periods
+		 * 
+		 * With a = tr(Tp)/2 and m = |Tp_10| of a lossless period, N periods reflect 
+		 * R = m^2 U^2 / (1 + m^2 U^2) with U = U_{N-1}(a) the Chebyshev polynomial of the 
+		 * second kind. In the passband |a| < 1, U^2 <= 1 / (1 - a^2) for every N, in the 
+		 * stopband R grows with N.
+		 */
+		double 
+		reflection_bound(const ctl& ctx, const section& s, size_t idx)
+		{
+			const double wavelength = ctx.wavelengths[idx];
+			auto Tp = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+			
+			Bragg grating(s.period, s.duty_cycle, s.N);
+			grating.transfer_matrix(Tp.get(), wavelength, 
+				(*ctx.n1)(wavelength, s.w1, idx), 
+				(*ctx.n2)(wavelength, s.w2, idx), 
+				(*ctx.loss)(wavelength, 0.0, idx));
+			
+			const double a = std::abs(0.5 * (Tp[0][0] + Tp[1][1]).real());
+			const double m2 = std::norm(Tp[1][0]);
+			
+			if (a < 1.0)
+				return m2 / (m2 + 1.0 - a * a);
+			
+			const double theta = std::acosh(a);
+			if (s.N * theta > 300.0)
+				return 1.0;
+			
+			const double U = theta > 0 ? std::sinh(s.N * theta) / std::sinh(theta) : s.N;
+			return m2 * U * U / (1.0 + m2 * U * U);
+		}
+	}
+
+	int 
+	search(const ctl& ctx)
+	{
+		// Nominal design, the first value of every axis
+		section nominal{
+			.period = ctx.periods[0], 
+			.duty_cycle = ctx.duty_cycles[0], 
+			.N = ctx.Ns[0],
+			.w1 = ctx.width1.empty() ? 0.0 : ctx.width1[0],
+			.w2 = ctx.width2.empty() ? 0.0 : ctx.width2[0]
+		};
+		
+		std::vector<axis> axes;
+		auto add = [&](const std::vector<double>& values, double section::* field)
+		{
+			if (values.size() < 2)
+				return;
+			auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+			axes.push_back({field, *lo, *hi});
+		};
+		
+		add(ctx.periods, &section::period);
+		add(ctx.duty_cycles, &section::duty_cycle);
+		add(ctx.Ns, &section::N);
+		add(ctx.width1, &section::w1);
+		add(ctx.width2, &section::w2);
+		
+		if (axes.empty())
+		{
+			std::cerr << "[ERROR] search: no search axes, specify a range as <min>,<max>" << std::endl;
+			return -1;
+		}
+		
+		const size_t D = axes.size();
+		const size_t corners = size_t{1} << D;
+		const uint64_t resolution = (ctx.grid - 1) << ctx.depth; ///< lattice intervals per axis
+		
+		auto design = [&](const std::vector<uint64_t>& node)
+		{
+			section s = nominal;
+			for (size_t d = 0; d < D; ++d)
+			{
+				const auto& a = axes[d];
+				double v = a.lower + (a.upper - a.lower) * node[d] / resolution;
+				s.*a.field = a.field == &section::N ? std::round(v) : v;
+			}
+			return s;
+		};
+		
+		auto corner = [&](const cell& c, size_t k)
+		{
+			std::vector<uint64_t> node = c.origin;
+			for (size_t d = 0; d < D; ++d)
+				if ((k >> d) & 1)
+					node[d] += c.size;
+			return node;
+		};
+		
+		// Wavelengths whose R_min a Bloch estimate can rule out
+		std::vector<size_t> reflective;
+		for (size_t i = 0; i < ctx.wavelengths.size(); ++i)
+			if (spec::at(ctx.target.R_min, i, 0.0) > 0)
+				reflective.push_back(i);
+		
+		std::vector<cell> active;
+		{
+			std::vector<uint64_t> origin(D, 0);
+			const uint64_t size = uint64_t{1} << ctx.depth;
+			while (true)
+			{
+				active.push_back({origin, size});
+				size_t d = 0;
+				for (; d < D; ++d)
+				{
+					origin[d] += size;
+					if (origin[d] < resolution)
+						break;
+					origin[d] = 0;
+				}
+				if (d == D)
+					break;
+			}
+		}
+		
+		std::map<std::vector<uint64_t>, double> penalty;
+		std::vector<std::vector<uint64_t>> feasible;
+		size_t evaluations = 0, bloch_pruned = 0, penalty_pruned = 0;
+		double threshold = INFINITY;
+		
+		// A scored node passing the mask on a neighbour sharing a face with the cell, 
+		// the corners of the cell shifted by one edge along one axis
+		auto near_pass = [&](const cell& c)
+		{
+			for (size_t k = 0; k < corners; ++k)
+				for (size_t d = 0; d < D; ++d)
+				{
+					auto node = corner(c, k);
+					const uint64_t x = node[d];
+					for (uint64_t y : {x - c.size, x + c.size})
+					{
+						// x - size wraps around below the lattice
+						if (y > resolution)
+							continue;
+						node[d] = y;
+						auto it = penalty.find(node);
+						if (it != penalty.end() && it->second == 0)
+							return true;
+					}
+				}
+			return false;
+		};
+		
+		for (size_t level = 0; level <= ctx.depth && !active.empty(); ++level)
+		{
+			// Bloch-trace estimate on the corners, with the largest N of the cell. A heuristic: 
+			// a stopband opening between the corners of a cell is missed
+			std::vector<char> blocked(active.size(), 0);
+			if (!reflective.empty())
+			{
+				parallel_for(active.size(), [&](size_t j, size_t)
+				{
+					const cell& c = active[j];
+					section top = design(corner(c, corners - 1));
+					
+					for (auto i : reflective)
+					{
+						const double R_min = spec::at(ctx.target.R_min, i, 0.0);
+						bool below = true;
+						for (size_t k = 0; k < corners && below; ++k)
+						{
+							section s = design(corner(c, k));
+							s.N = top.N;
+							below = reflection_bound(ctx, s, i) < R_min;
+						}
+						if (below)
+						{
+							blocked[j] = 1;
+							return;
+						}
+					}
+				}, ctx.threads);
+			}
+			
+			// Score the new corners of the remaining cells
+			std::vector<std::vector<uint64_t>> pending;
+			for (size_t j = 0; j < active.size(); ++j)
+			{
+				if (blocked[j])
+					continue;
+				for (size_t k = 0; k < corners; ++k)
+				{
+					auto node = corner(active[j], k);
+					if (penalty.emplace(node, 0.0).second)
+						pending.push_back(std::move(node));
+				}
+			}
+			
+			std::vector<double> scores(pending.size());
+			parallel_for(pending.size(), [&](size_t j, size_t)
+			{
+				scores[j] = objective(ctx, {design(pending[j])});
+			}, ctx.threads);
+			
+			for (size_t j = 0; j < pending.size(); ++j)
+			{
+				penalty[pending[j]] = scores[j];
+				if (scores[j] == 0)
+					feasible.push_back(pending[j]);
+			}
+			evaluations += pending.size();
+			
+			// Smallest and largest corner penalty of each remaining cell
+			std::vector<double> lo(active.size(), INFINITY), hi(active.size(), 0);
+			for (size_t j = 0; j < active.size(); ++j)
+			{
+				if (blocked[j])
+					continue;
+				for (size_t k = 0; k < corners; ++k)
+				{
+					const double p = penalty[corner(active[j], k)];
+					lo[j] = std::min(lo[j], p);
+					hi[j] = std::max(hi[j], p);
+				}
+			}
+			
+			// The threshold starts at the median smallest penalty of the coarse cells with no passing 
+			// corner and halves with the cell edge
+			if (level == 0)
+			{
+				std::vector<double> failing;
+				for (size_t j = 0; j < active.size(); ++j)
+					if (!blocked[j] && lo[j] > 0)
+						failing.push_back(lo[j]);
+				if (!failing.empty())
+				{
+					std::nth_element(failing.begin(), failing.begin() + failing.size() / 2, failing.end());
+					threshold = failing[failing.size() / 2];
+				}
+			}
+			else
+				threshold /= 2;
+			
+			std::vector<cell> next;
+			size_t kept = 0;
+			
+			for (size_t j = 0; j < active.size(); ++j)
+			{
+				if (blocked[j])
+				{
+					bloch_pruned++;
+					continue;
+				}
+				
+				// Every corner passes, the cell is taken as feasible
+				if (hi[j] == 0)
+					continue;
+				
+				// Neither a passing corner on a neighbour nor a corner penalty below the threshold 
+				// (a passing corner of its own is one), the cell is dropped
+				if (lo[j] >= threshold && !near_pass(active[j]))
+				{
+					penalty_pruned++;
+					continue;
+				}
+				
+				kept++;
+				if (level == ctx.depth)
+					continue;
+				
+				const uint64_t half = active[j].size / 2;
+				for (size_t k = 0; k < corners; ++k)
+				{
+					cell child{active[j].origin, half};
+					for (size_t d = 0; d < D; ++d)
+						if ((k >> d) & 1)
+							child.origin[d] += half;
+					next.push_back(std::move(child));
+				}
+			}
+			
+			std::cerr << "[INFO] search: level " << level << ": " << active.size() << " cells, " 
+				<< kept << " refined, " << evaluations << " evaluations" << std::endl;
+			
+			active = std::move(next);
+		}
+		
+		double dense = 1;
+		for (size_t d = 0; d < D; ++d)
+			dense *= resolution + 1;
+		
+		std::cerr << "[INFO] search: " << evaluations << " evaluations, " 
+			<< 100.0 * evaluations / dense << "% of the dense grid, " 
+			<< penalty_pruned << " cells pruned by the penalty threshold and " 
+			<< bloch_pruned << " by the Bloch estimate (heuristics), " 
+			<< feasible.size() << " passing designs" << std::endl;
+		
+		bool sweep_width1 = !ctx.width1.empty();
+		bool sweep_width2 = !ctx.width2.empty();
+		
+		printf("period,duty_cycle,N");
+		if (sweep_width1) printf(",w1");
+		if (sweep_width2) printf(",w2");
+		printf("\n");
+		
+		std::sort(feasible.begin(), feasible.end());
+		for (const auto& node : feasible)
+		{
+			const auto s = design(node);
+			printf("%.6g,%.6g,%.6g", s.period, s.duty_cycle, s.N);
+			if (sweep_width1) printf(",%.6g", s.w1);
+			if (sweep_width2) printf(",%.6g", s.w2);
+			printf("\n");
+		}
+		
+		return 0;
+	}
+}//namespace tmm
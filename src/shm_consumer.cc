@@ -0,0 +1,147 @@
+/**
+ * \file shm_consumer.cc
+ * \brief Reference consumer of shared memory result rings
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <shm.h>
+#include <iostream>
+#include <cstdio>
+#include <getopt.h>
+
+using namespace tmm;
+
+const char* usage = \
+	"usage: tmm-shm-consumer [opts] <name>\n"
+	"\tReads the records of a tmm --shm-output ring and writes them as csv\n"
+	"\t-q, --quiet                 Consume the records without writing them\n"
+	"\t-t, --timeout  <val>        Seconds to wait for the producer (default 10)\n"
+	"\t-k, --keep                  Keep the shared memory object instead of removing it\n";
+
+int main(int argc, char** argv)
+{
+	bool quiet = false, keep = false;
+	double timeout = 10;
+	
+	static struct option long_options[] = 
+	{
+		{"quiet",			no_argument,       0, 'q'},
+		{"timeout",			required_argument, 0, 't'},
+		{"keep",			no_argument,       0, 'k'},
+		{"help",			no_argument,       0, 'h'},
+		{0, 0, 0, 0}
+	};
+	
+	int c, option_index = 0;
+	while ((c = getopt_long(argc, argv, "hkqt:", long_options, &option_index)) != -1)
+	{
+		switch (c)
+		{
+			case 'q': quiet = true; break;
+			case 'k': keep = true; break;
+			case 't': timeout = std::strtod(optarg, nullptr); break;
+			case 'h':
+			default:
+				std::cerr << usage << std::endl;
+				return -1;
+		}
+	}
+	
+	if (optind + 1 != argc)
+	{
+		std::cerr << usage << std::endl;
+		return -1;
+	}
+	
+	std::string name{argv[optind]};
+	if (!name.starts_with('/'))
+		name = "/" + name;
+	
+	try
+	{
+		shm_consumer ring(name, timeout);
+		const uint32_t fields = ring.info().fields;
+		
+		// Scattering parameters take two columns, the real and imaginary parts
+		constexpr size_t scalars = 14;
+		if (!quiet)
+		{
+			std::string header;
+			for (size_t i = 0; i < std::size(shm_field_names); ++i)
+			{
+				if (!(fields & (1u << i)))
+					continue;
+				if (!header.empty())
+					header += ',';
+				header += shm_field_names[i];
+				if (i >= scalars)
+					header += std::string("_re,") + shm_field_names[i] + "_im";
+			}
+			std::printf("%s\n", header.c_str());
+		}
+		
+		uint64_t records = 0;
+		for (auto span = ring.acquire(); !span.empty(); span = ring.acquire())
+		{
+			for (const auto& record : quiet ? std::span<const shm_record>{} : span)
+			{
+				const double* values = &record.period;
+				const char* separator = "";
+				for (size_t i = 0; i < std::size(shm_field_names); ++i)
+				{
+					if (!(fields & (1u << i)))
+						continue;
+					if (i < scalars)
+						std::printf("%s%.6g", separator, values[i]);
+					else
+						std::printf("%s%.6g,%.6g", separator, values[scalars + 2 * (i - scalars)], values[scalars + 2 * (i - scalars) + 1]);
+					separator = ",";
+				}
+				std::printf("\n");
+			}
+			records += span.size();
+			ring.release(span.size());
+		}
+		
+		const bool failed = ring.state() == SHM_FAILED;
+		if (!keep)
+			shm_unlink(name.c_str());
+		
+		std::cerr << "[INFO] shm: " << records << " of " << ring.info().records << " records" << std::endl;
+		if (failed)
+		{
+			std::cerr << "[ERROR] shm: the producer stopped early" << std::endl;
+			return 1;
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << "[ERROR] shm: " << ex.what() << std::endl;
+		return -1;
+	}
+	
+	return 0;
+}
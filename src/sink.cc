@@ -0,0 +1,72 @@
+/**
+ * \file sink.cc
+ * \brief Output sinks of sweeps
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <sink.h>
+#include <uring.h>
+#include <ctl.h>
+#include <fcntl.h>
+#include <iostream>
+
+namespace tmm
+{
+	std::unique_ptr<sink> open_sink(const ctl& ctx)
+	{
+		int fd = STDOUT_FILENO;
+		bool owned = false;
+		if (!ctx.output.empty())
+		{
+			fd = open(ctx.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | (ctx.direct ? O_DIRECT : 0), 0644);
+			if (fd == -1)
+				throw std::runtime_error("open " + ctx.output + ": " + std::strerror(errno));
+			owned = true;
+		}
+		
+		if (ctx.writer == WRITER_URING)
+		{
+			try
+			{
+				return std::make_unique<uring_sink>(fd, owned);
+			}
+			catch (const std::exception& ex)
+			{
+				std::cerr << "[WARN] sweep: " << ex.what() << ", writing with write()" << std::endl;
+			}
+		}
+		
+		// write(2) takes unaligned buffers only through the page cache
+		if (ctx.direct)
+		{
+			const int flags = fcntl(fd, F_GETFL);
+			if (flags != -1)
+				fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+		}
+		
+		return std::make_unique<fd_sink>(fd, owned);
+	}
+}//namespace tmm
@@ -0,0 +1,181 @@
+/**
+ * \file spectrum.cc
+ * \brief implementations for spectrum.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <spectrum.h>
+#include <mapping.h>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+
+namespace tmm
+{
+	namespace
+	{
+		void sort(spectrum& s)
+		{
+			if (std::is_sorted(s.wavelength.begin(), s.wavelength.end()))
+				return;
+			
+			std::vector<size_t> order(s.wavelength.size());
+			std::iota(order.begin(), order.end(), 0);
+			std::sort(order.begin(), order.end(), 
+				[&](size_t a, size_t b) { return s.wavelength[a] < s.wavelength[b]; });
+			
+			spectrum sorted;
+			for (auto i : order)
+			{
+				sorted.wavelength.push_back(s.wavelength[i]);
+				sorted.value.push_back(s.value[i]);
+			}
+			s = std::move(sorted);
+		}
+
+		void parse_text(const char* p, const char* end, std::vector<spectrum>& spectra)
+		{
+			spectrum current;
+			
+			while (p < end)
+			{
+				const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+				if (!eol) 
+					eol = end;
+				
+				std::string line(p, eol);
+				p = eol + 1;
+				
+				size_t first = line.find_first_not_of(" \t\r");
+				if (first == std::string::npos)
+				{
+					if (!current.wavelength.empty())
+						spectra.push_back(std::move(current));
+					current = spectrum{};
+					continue;
+				}
+				
+				const char* s = line.c_str() + first;
+				char* next = nullptr;
+				double l = std::strtod(s, &next);
+				if (next == s)
+					continue;
+				
+				while (*next == ',' || *next == ' ' || *next == '\t')
+					++next;
+				
+				char* last = nullptr;
+				double v = std::strtod(next, &last);
+				if (last == next)
+					continue;
+				
+				current.wavelength.push_back(l);
+				current.value.push_back(v);
+			}
+			
+			if (!current.wavelength.empty())
+				spectra.push_back(std::move(current));
+		}
+
+		void parse_binary(const char* p, const char* end, std::vector<spectrum>& spectra)
+		{
+			while (p + sizeof(uint64_t) <= end)
+			{
+				uint64_t count;
+				std::memcpy(&count, p, sizeof(count));
+				p += sizeof(count);
+				
+				if (count > static_cast<uint64_t>(end - p) / (2 * sizeof(double)))
+					throw std::runtime_error("truncated spectrum record");
+				
+				spectrum s;
+				s.wavelength.resize(count);
+				s.value.resize(count);
+				
+				for (uint64_t i = 0; i < count; ++i)
+				{
+					std::memcpy(&s.wavelength[i], p, sizeof(double));
+					std::memcpy(&s.value[i], p + sizeof(double), sizeof(double));
+					p += 2 * sizeof(double);
+				}
+				
+				spectra.push_back(std::move(s));
+			}
+		}
+	}
+
+	std::vector<spectrum> 
+	load_spectra(const std::string& path)
+	{
+		mapping file(path);
+		std::vector<spectrum> spectra;
+		
+		if (file.size() == 0)
+			return spectra;
+		
+		if (is_text(file.data(), file.size()))
+			parse_text(file.data(), file.data() + file.size(), spectra);
+		else
+			parse_binary(file.data(), file.data() + file.size(), spectra);
+		
+		for (auto& s : spectra)
+			sort(s);
+		
+		return spectra;
+	}
+
+	std::vector<double> 
+	resample(const spectrum& s, const std::vector<double>& grid)
+	{
+		if (s.wavelength.empty())
+			throw std::runtime_error("empty spectrum");
+		
+		std::vector<double> out(grid.size());
+		
+		for (size_t i = 0; i < grid.size(); ++i)
+		{
+			const double l = grid[i];
+			auto it = std::lower_bound(s.wavelength.begin(), s.wavelength.end(), l);
+			
+			if (it == s.wavelength.begin())
+				out[i] = s.value.front();
+			else if (it == s.wavelength.end())
+				out[i] = s.value.back();
+			else
+			{
+				size_t j = it - s.wavelength.begin();
+				double l0 = s.wavelength[j - 1], l1 = s.wavelength[j];
+				double f = (l1 == l0) ? 0.0 : (l - l0) / (l1 - l0);
+				out[i] = s.value[j - 1] + f * (s.value[j] - s.value[j - 1]);
+			}
+		}
+		
+		return out;
+	}
+}//namespace tmm
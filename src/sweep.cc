@@ -0,0 +1,463 @@
+/**
+ * \file sweep.cc
+ * \brief sweeps of the bragg device
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <sweep.h>
+#include <bragg.h>
+#include <sampling.h>
+#include <plan.h>
+#include <batch.h>
+#include <linewidth.h>
+#include <format.h>
+#include <pipeline.h>
+#include <sink.h>
+#include <shm.h>
+#include <iostream>
+#include <optional>
+#include <cmath>
+#include <unistd.h>
+
+namespace tmm
+{
+	namespace
+	{
+		constexpr size_t block_rows = 4096; ///< rows per pipeline block
+		constexpr size_t blocks_per_thread = 4; ///< block buffers in flight per worker thread
+		constexpr size_t shm_ring_records = size_t(1) << 16; ///< most records of shared memory rings, 11 MiB
+
+		/**
+		 * \brief Design points of a sweep and their results, passed between pipeline stages
+		 */
+		struct sweep_block
+		{
+			size_t index = 0; ///< block number
+			size_t begin = 0, end = 0; ///< design points
+			std::vector<double> R, T, r, t; ///< per point, wavelengths innermost
+			std::vector<double> group_delay; ///< per point, with group delay columns
+			std::vector<sparameters> S; ///< per point, with S-parameter columns
+			std::string text; ///< formatted rows
+		};
+
+		/**
+		 * \brief Working storage of a scalar kernel thread
+		 */
+		struct scalar_state
+		{
+			decltype(damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2)) Tp, M;
+			std::vector<std::complex<double>> cache; ///< period matrices of the first N of a cartesian block
+			std::vector<double> R_points, T_points, r_points, t_points; ///< line shape averaging points
+
+			/**
+			 * \param cache period matrices held by the cache
+			 */
+			explicit scalar_state(size_t cache) : 
+			Tp(damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2)), 
+			M(damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2)), 
+			cache(4 * cache)
+			{ }
+		};
+	}
+
+	int sweep(const ctl& ctx)
+	{
+		const bool sweep_width1 = !ctx.width1.empty();
+		const bool sweep_width2 = !ctx.width2.empty();
+		const bool analyze_group_delay = ctx.dl && (ctx.columns & COL_GROUP_DELAY);
+		const bool phases = ctx.columns & (COL_PHASE_R | COL_PHASE_T);
+		const uint16_t columns = analyze_group_delay ? ctx.columns : ctx.columns & ~COL_GROUP_DELAY;
+		
+		const auto points = designs(ctx);
+		const auto plan = plan_sweep(ctx, points);
+		if (ctx.explain)
+		{
+			explain(ctx, points, plan, stdout);
+			return 0;
+		}
+		std::cerr << "[INFO] sweep: " << plan.candidates.front().name << std::endl;
+		
+		// Records go to a shared memory ring, text to the sink
+		std::unique_ptr<shm_producer> ring;
+		std::unique_ptr<sink> out;
+		if (!ctx.shm_output.empty())
+		{
+			uint32_t fields = 0xf;
+			if (sweep_width1) fields |= 1u << 4;
+			if (sweep_width2) fields |= 1u << 5;
+			for (size_t i = 0; i < std::size(column_names); ++i)
+				if (columns & column_names[i].second)
+					fields |= 1u << (6 + i);
+			if (ctx.sparameters != SP_NONE)
+				fields |= 0xfu << 14;
+			
+			const uint64_t records = points.size() * ctx.wavelengths.size();
+			ring = std::make_unique<shm_producer>(ctx.shm_output, std::min<uint64_t>(records, shm_ring_records), 
+				records, fields, ctx.shm_replace);
+			std::cerr << "[INFO] sweep: publishing " << records << " records to shared memory " << ctx.shm_output << std::endl;
+		}
+		else
+		{
+			out = open_sink(ctx);
+			std::string header = "period,duty_cycle,N,wavelength";
+			if (sweep_width1) header += ",w1";
+			if (sweep_width2) header += ",w2";
+			format_column_header(header, columns);
+			format_sparameter_header(header, ctx.sparameters);
+			header += '\n';
+			fflush(stdout);
+			out->write(header.data(), header.size());
+		}
+
+		const size_t D = points.size(), K = ctx.wavelengths.size();
+		const material n1(*ctx.n1, ctx.wavelengths, points, &design::w1, plan.tables[0]);
+		const material n2(*ctx.n2, ctx.wavelengths, points, &design::w2, plan.tables[1]);
+		const material loss(*ctx.loss, ctx.wavelengths, points, nullptr, plan.tables[2]);
+
+		// Line shape averaging of R and T, evaluated once per design on the planned points
+		std::optional<spectral_average> average;
+		if (ctx.linewidth > 0)
+		{
+			average.emplace(ctx);
+			std::cerr << "[INFO] sweep: linewidth averaging from " << average->points().size() 
+				<< " evaluations for " << K << " wavelengths" << std::endl;
+		}
+
+		const auto grid = uniform_wavenumber(ctx.wavelengths);
+		std::atomic<size_t> recurrent_designs{0};
+
+		// Designs per block: whole batches of design-major packing, whole N axes of the period cache
+		const size_t inner = std::max<size_t>(ctx.width1.size(), 1) * std::max<size_t>(ctx.width2.size(), 1);
+		size_t block_designs = std::max<size_t>(block_rows / std::max<size_t>(K, 1), 1);
+		if (plan.kernel == KERNEL_BATCH && plan.packing == PACK_DESIGN)
+			block_designs = (block_designs + batch_lanes - 1) / batch_lanes * batch_lanes;
+		if (plan.kernel == KERNEL_SCALAR && plan.period_cache)
+			block_designs = (block_designs + inner * ctx.Ns.size() - 1) / (inner * ctx.Ns.size()) * inner * ctx.Ns.size();
+		
+		// Workers split between the kernel and formatting by their estimated costs
+		const size_t threads = concurrency(ctx.threads);
+		pipeline_threads split;
+		split.compute = std::clamp<size_t>(std::llround(threads * plan.evaluation / (plan.evaluation + plan.output)), 
+			1, std::max<size_t>(threads - 1, 1));
+		split.format = std::max<size_t>(threads - split.compute, 1);
+		if (ring)
+			split = {threads, 1};
+		
+		std::vector<scalar_state> states;
+		states.reserve(split.compute);
+		for (size_t t = 0; plan.kernel == KERNEL_SCALAR && t < split.compute; ++t)
+			states.emplace_back(plan.period_cache ? inner * K : 0);
+
+		// Design-major batches take one wavelength of `chunk` designs, wavelength-major ones the spectrum of one design
+		auto batch_kernel = [&](sweep_block& block)
+		{
+			constexpr size_t W = batch_lanes;
+			const size_t chunk = plan.packing == PACK_DESIGN ? W : 1;
+			batch_result<W> result;
+			
+			for (size_t begin = block.begin; begin < block.end; begin += chunk)
+			{
+				const size_t count = std::min(chunk, block.end - begin);
+				
+				for (size_t first = 0; first < count * K; first += W)
+				{
+					design_batch<W> batch;
+					batch.count = std::min(W, count * K - first);
+					for (size_t l = 0; l < W; ++l)
+					{
+						const size_t p = first + (l < batch.count ? l : 0);
+						const size_t k = p / count;
+						const auto& d = points[begin + p % count];
+						batch.wavelength[l] = ctx.wavelengths[k];
+						batch.period[l] = d.period;
+						batch.duty_cycle[l] = d.duty_cycle;
+						batch.N[l] = static_cast<uint64_t>(d.N);
+						batch.n1[l] = n1(d, n1.row(d), k);
+						batch.n2[l] = n2(d, n2.row(d), k);
+						batch.loss[l] = loss(d, 0, k);
+					}
+					batch_coefficients(batch, phases, result);
+					
+					for (size_t l = 0; l < batch.count; ++l)
+					{
+						const size_t p = first + l;
+						const size_t j = (begin - block.begin + p % count) * K + p / count;
+						block.R[j] = result.R[l];
+						block.T[j] = result.T[l];
+						block.r[j] = result.r[l];
+						block.t[j] = result.t[l];
+					}
+				}
+			}
+		};
+
+		auto scalar_kernel = [&](sweep_block& block, scalar_state& state)
+		{
+			auto& Tp = state.Tp;
+			auto& M = state.M;
+			
+			for (size_t i = block.begin; i < block.end; ++i)
+			{
+				const auto& d = points[i];
+				const auto& [period, duty_cycle, N, w1, w2] = d;
+				Bragg grating(period, duty_cycle, N);
+				const size_t row1 = n1.row(d), row2 = n2.row(d);
+				
+				// Period matrices of the first N of every cartesian block, read back by the following N
+				const bool cached = plan.period_cache && (i / inner) % ctx.Ns.size() > 0;
+				std::complex<double>* slot = plan.period_cache ? state.cache.data() + (i % inner) * K * 4 : nullptr;
+
+				std::optional<phase_recurrence> phase1, phase2;
+				if (plan.phase == PHASE_RECURRENCE && !cached && recurrent(ctx, grid, d))
+				{
+					const double loss_grid = (*ctx.loss)(0.0, 0.0);
+					phase1.emplace(grid, (*ctx.n1)(0.0, w1), period * duty_cycle, loss_grid);
+					phase2.emplace(grid, (*ctx.n2)(0.0, w2), period * (1.0 - duty_cycle), loss_grid);
+					recurrent_designs++;
+				}
+
+				if (average)
+				{
+					const auto& points = average->points();
+					state.R_points.resize(points.size());
+					state.T_points.resize(points.size());
+					state.r_points.resize(points.size());
+					state.t_points.resize(points.size());
+					
+					for (size_t j = 0; j < points.size(); ++j)
+						std::tie(state.R_points[j], state.T_points[j], state.r_points[j], state.t_points[j]) = 
+							grating.scattering_coefficients(
+								points[j], 
+								(*ctx.n1)(points[j], w1), 
+								(*ctx.n2)(points[j], w2), 
+								(*ctx.loss)(points[j], 0.0),
+								phases);
+				}
+
+				for (size_t idx = 0; idx < K; ++idx)
+				{
+					const size_t j = (i - block.begin) * K + idx;
+					const double wavelength = ctx.wavelengths[idx];
+					const double n1_val = n1(d, row1, idx);
+					const double n2_val = n2(d, row2, idx);
+					const double loss_val = loss(d, 0, idx);
+
+					// Compute reflection and transmission, from the full scattering parameters when requested
+					double R, T, r, t;
+					if (average && ctx.sparameters == SP_NONE && average->nominal(idx) != spectral_average::npos)
+					{
+						r = state.r_points[average->nominal(idx)];
+						t = state.t_points[average->nominal(idx)];
+					}
+					else
+					{
+						// Period matrix from the cache, the phase recurrence or the layer exponentials
+						std::complex<double>* entry = slot ? slot + 4 * idx : nullptr;
+						if (cached)
+						{
+							Tp[0][0] = entry[0]; Tp[0][1] = entry[1];
+							Tp[1][0] = entry[2]; Tp[1][1] = entry[3];
+						}
+						else
+						{
+							const double k = 2.0 * pi / wavelength;
+							const double l1 = period * duty_cycle, l2 = period * (1.0 - duty_cycle);
+							const auto p1 = phase1 ? (*phase1)(idx, k) : std::exp(std::complex<double>(0.5 * loss_val * l1, k * n1_val * l1));
+							const auto p2 = phase2 ? (*phase2)(idx, k) : std::exp(std::complex<double>(0.5 * loss_val * l2, k * n2_val * l2));
+							grating.transfer_matrix(Tp.get(), p1, p2, n1_val, n2_val);
+							
+							if (entry)
+							{
+								entry[0] = Tp[0][0]; entry[1] = Tp[0][1];
+								entry[2] = Tp[1][0]; entry[3] = Tp[1][1];
+							}
+						}
+						
+						if (plan.power == POWER_CHEBYSHEV)
+							chebyshev_power(Tp.get(), M.get(), static_cast<size_t>(N));
+						else
+							matrix_power(Tp.get(), M.get(), static_cast<size_t>(N));
+						
+						if (ctx.sparameters != SP_NONE)
+						{
+							const auto& S = block.S[j] = tmm::scattering_parameters(M.get());
+							R = std::norm(S.S11);
+							T = std::norm(S.S21);
+							r = phases ? std::arg(S.S11) : NAN;
+							t = phases ? std::arg(S.S21) : NAN;
+						}
+						else
+							tmm::scattering_coefficients(M.get(), R, T, r, t, phases);
+					}
+					
+					if (average)
+					{
+						R = (*average)(state.R_points, idx);
+						T = (*average)(state.T_points, idx);
+					}
+					
+					block.R[j] = R;
+					block.T[j] = T;
+					block.r[j] = r;
+					block.t[j] = t;
+					
+					//todo: support sampled data
+					if (analyze_group_delay)
+					{
+						block.group_delay[j] = 0;
+						if (!ctx.n1->sampled && !ctx.n2->sampled && !ctx.loss->sampled)
+						{
+							auto dwb = wavelength - ctx.dl; //backward difference
+							auto dwf = wavelength + ctx.dl; //forward difference
+
+							auto [Rb, Tb, rb, tb] = grating.scattering_coefficients(
+								dwb, 
+								(*ctx.n1)(dwb, w1, idx), 
+								(*ctx.n2)(dwb, w2, idx), 
+								loss_val
+							);
+
+							auto [Rf, Tf, rf, tf] = grating.scattering_coefficients(
+								dwf,
+								(*ctx.n1)(dwf, w1, idx), 
+								(*ctx.n2)(dwf, w2, idx), 
+								loss_val
+							);
+							//group delay of transmission 
+							block.group_delay[j] = tmm::group_delay(tb, tf, dwb, dwf);
+						}
+					}
+				}
+			}
+		};
+
+		pipeline<sweep_block>((D + block_designs - 1) / block_designs, blocks_per_thread * threads, split,
+			[&](sweep_block& block)
+			{
+				block.begin = block.index * block_designs;
+				block.end = std::min(block.begin + block_designs, D);
+				
+				const size_t size = (block.end - block.begin) * K;
+				block.R.resize(size);
+				block.T.resize(size);
+				block.r.resize(size);
+				block.t.resize(size);
+				block.group_delay.resize(analyze_group_delay ? size : 0);
+				block.S.resize(ctx.sparameters != SP_NONE ? size : 0);
+			},
+			[&](sweep_block& block, size_t thread)
+			{
+				if (plan.kernel == KERNEL_BATCH)
+					batch_kernel(block);
+				else
+					scalar_kernel(block, states[thread]);
+			},
+			[&](sweep_block& block, size_t)
+			{
+				block.text.clear();
+				if (ring)
+					return;
+				
+				for (size_t i = block.begin; i < block.end; ++i)
+				{
+					const auto& d = points[i];
+					const size_t row1 = n1.row(d), row2 = n2.row(d);
+					
+					for (size_t k = 0; k < K; ++k)
+					{
+						const size_t j = (i - block.begin) * K + k;
+						append(block.text, d.period);
+						append_field(block.text, d.duty_cycle);
+						append_field(block.text, d.N);
+						append_field(block.text, ctx.wavelengths[k]);
+						if (sweep_width1) append_field(block.text, d.w1);
+						if (sweep_width2) append_field(block.text, d.w2);
+						format_columns(block.text, columns, {n1(d, row1, k), n2(d, row2, k), loss(d, 0, k), 
+							block.R[j], block.T[j], block.r[j], block.t[j], 
+							analyze_group_delay ? block.group_delay[j] : 0.0});
+						if (ctx.sparameters != SP_NONE)
+							format_sparameters(block.text, ctx.sparameters, block.S[j]);
+						block.text += '\n';
+					}
+				}
+			},
+			[&](sweep_block& block)
+			{
+				if (!ring)
+				{
+					out->write(block.text.data(), block.text.size());
+					return;
+				}
+				
+				// Records are built in place in the ring, in output order
+				auto pick = [&](uint16_t column, double value) { return columns & column ? value : NAN; };
+				const size_t count = (block.end - block.begin) * K;
+				for (size_t j = 0; j < count; )
+				{
+					auto slots = ring->reserve(count - j);
+					for (auto& record : slots)
+					{
+						const auto& d = points[block.begin + j / K];
+						const size_t k = j % K;
+						
+						record.period = d.period;
+						record.duty_cycle = d.duty_cycle;
+						record.N = d.N;
+						record.wavelength = ctx.wavelengths[k];
+						record.w1 = sweep_width1 ? d.w1 : NAN;
+						record.w2 = sweep_width2 ? d.w2 : NAN;
+						record.n1 = pick(COL_N1, n1(d, n1.row(d), k));
+						record.n2 = pick(COL_N2, n2(d, n2.row(d), k));
+						record.loss = pick(COL_LOSS, loss(d, 0, k));
+						record.R = pick(COL_R, block.R[j]);
+						record.T = pick(COL_T, block.T[j]);
+						record.phase_r = pick(COL_PHASE_R, block.r[j]);
+						record.phase_t = pick(COL_PHASE_T, block.t[j]);
+						record.group_delay = analyze_group_delay ? pick(COL_GROUP_DELAY, block.group_delay[j]) : NAN;
+						
+						const sparameters S = ctx.sparameters != SP_NONE ? block.S[j] : sparameters{NAN, NAN, NAN, NAN};
+						record.S11[0] = S.S11.real(); record.S11[1] = S.S11.imag();
+						record.S21[0] = S.S21.real(); record.S21[1] = S.S21.imag();
+						record.S12[0] = S.S12.real(); record.S12[1] = S.S12.imag();
+						record.S22[0] = S.S22.real(); record.S22[1] = S.S22.imag();
+						++j;
+					}
+					ring->publish(slots.size());
+				}
+			});
+		
+		if (ring)
+			ring->close();
+		else
+			out->flush();
+
+		if (recurrent_designs)
+			std::cerr << "[INFO] sweep: layer phases by recurrence on the uniform wave-number grid for " 
+				<< recurrent_designs << " designs" << std::endl;
+		
+		return 0;
+	}
+}//namespace tmm
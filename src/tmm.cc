@@ -25,19 +25,73 @@
 
 #include <iostream>
 #include <memory>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
 #include <getopt.h>
 #include <ctl.h>
 #include <bragg.h>
+#include <optimize.h>
+#include <fit.h>
+#include <montecarlo.h>
+#include <uq.h>
+#include <sampling.h>
+#include <search.h>
+#include <pareto.h>
+#include <field.h>
+#include <dfb.h>
+#include <kerr.h>
+#include <pulse.h>
+#include <vectfit.h>
+#include <sweep.h>
+#include <format.h>
+#include <disordered.h>
+#include <profile.h>
 
 using namespace std;
 using namespace tmm;
 
 const char* usage = \
-	"usage: tmm [opts]\n"
+	"usage: tmm [task] [opts]\n"
+	"\nTasks:\n"
+	"\tsweep                                   Evaluate every parameter combination (default)\n"
+	"\toptimize                                Inverse design against a spectral mask\n"
+	"\tfit                                     Extract model parameters from a measured spectrum\n"
+	"\tfit-batch                               Extract model parameters from many spectra in parallel\n"
+	"\tmontecarlo                              Yield analysis under process variation\n"
+	"\tuq                                      Polynomial chaos uncertainty quantification\n"
+	"\tsearch                                  Coarse-to-fine search for designs meeting a spectral mask\n"
+	"\tpareto                                  Front of peak R, bandwidth, length and sidelobe over a sweep\n"
+	"\tfield                                   Forward/backward power and amplitude along the nominal grating\n"
+	"\tdfb                                     Threshold gain and lasing wavelength of DFB lasers\n"
+	"\tkerr                                    Bistability map of a Kerr-nonlinear grating\n"
+	"\tpulse                                   Reflected and transmitted Gaussian pulses of the nominal grating\n"
+	"\tvectfit                                 Pole-residue models of S11, S21, S22 over a sweep\n"
 	"\nGeneral Control:\n"
-	"\t-d, --device         <type>             Devices supported: 'bragg' \n"
-	"\t-l, --wavelength     <val>[,...]        Wavelength(s) \n"
+	"\t-d, --device         <type>             Devices supported: 'bragg', 'disordered', 'profile' \n"
+	"\t-l, --wavelength     <val>[,...]        Wavelength(s), in um for pulse and vectfit\n"
 	"\t--dl     			<val>		       Group delay wavelength interval \n"
+	"\t--decimate           <val>              Periods between written boundaries, field (default 1)\n"
+	"\t                                        **field energy is |a|^2+|b|^2 of the incident-normalized waves\n"
+	"\t--gain               [min,]<max>        Modal gain window searched for lasing modes, dfb\n"
+	"\t--kerr               <val>              Nonlinear index n = n0 + kerr*I, kerr\n"
+	"\t--power              [min,]<max>        Output power range of the continuation, kerr\n"
+	"\t--steps              <val>              Largest continuation step is the range/steps (default 200)\n"
+	"\t--pulse-width        <val>              Intensity FWHM of the input pulse (ps), pulse\n"
+	"\t--carrier            <val>              Carrier wavelength (um), pulse (default the window centre)\n"
+	"\t--fft-size           <val>              Frequency samples across the window, pulse (default 4096)\n"
+	"\t--pad                <val>              Zero-padding factor of the time axis, pulse (default 1)\n"
+	"\t--window             <type>             Spectral window: 'none' (default), 'hann', 'tukey'\n"
+	"\t--poles              <val>              Poles of the rational models, vectfit (default 20)\n"
+	"\t--sparams                               Add magnitude and phase of S11, S21, S12, S22 to sweeps\n"
+	"\t--complex                               Add real and imaginary parts of S11, S21, S12, S22 to sweeps\n"
+	"\t--sampling           <type>             Sweep designs: 'cartesian' (default), 'sobol', 'lhs'\n"
+	"\t                                        sobol/lhs draw --samples designs within the axis bounds\n"
+	"\t--linewidth          <val>              FWHM of the source or detector line, averages R and T of sweeps\n"
+	"\t--lineshape          <type>             Line shape: 'gaussian' (default), 'lorentzian', 'sinc2'\n"
+	"\t--columns            <name>[,...]       Sweep columns computed and written, any of\n"
+	"\t                                        n1,n2,loss,R,T,phase_r,phase_t,group_delay (default all)\n"
+	"\t--explain                               Print the evaluation plan of a bragg sweep instead of running it\n"
 	"\nBragg Control:\n"
 	"\t-p, --period         <val>[,...]        Grating period(s) \n"
 	"\t-c, --dutycycle      <val>[,...]        Dutycycle(s) 0-1\n"
@@ -54,11 +108,143 @@ const char* usage = \
 	"\t--w2                 <val>[,...]        Width(s) for low-index region\n"
 	"\t--n1-width-model     <w0,b0,b1,b2,b3,...>  dn1(w) = b1*(w-w0) + b2*(w-w0)^2 + b3*(w-w0)^3\n"
 	"\t--n2-width-model     <w0,b0,b1,b2,b3,...>  dn2(w) = b1*(w-w0) + b2*(w-w0)^2 + b3*(w-w0)^3\n"
-	"\t**if using --n#-model and --n#-width-model together specify b0 as 0.0";
+	"\t**if using --n#-model and --n#-width-model together specify b0 as 0.0\n"
+	"\nDisordered Control:\n"
+	"\t--disorder-width     <val>              Standard deviation of each width per period\n"
+	"\t--disorder-duty      <val>              Standard deviation of the dutycycle per period\n"
+	"\t--correlation-length <val>              Correlation length of the disorder along the grating\n"
+	"\t--realizations       <val>              Realizations averaged per design (with --seed)\n"
+	"\nProfile Control:\n"
+	"\t--profile            <file>             Layer file, 'length,n,loss' text or float64 triples\n"
+	"\nSpectral Mask:\n"
+	"\t--r-min              <val>[,...]        Lower bound on R per wavelength\n"
+	"\t--r-max              <val>[,...]        Upper bound on R per wavelength\n"
+	"\t--t-min              <val>[,...]        Lower bound on T per wavelength\n"
+	"\t--t-max              <val>[,...]        Upper bound on T per wavelength\n"
+	"\t--weight             <val>[,...]        Objective weight per wavelength, 0 masks out\n"
+	"\nOptimize Control:\n"
+	"\t**parameters given as <min>,<max> are optimized within that range\n"
+	"\t--sections           <val>              Number of independently optimized sections\n"
+	"\t--iterations         <val>              Optimizer iteration or generation limit\n"
+	"\t--method             <type>             Optimizers supported: 'lbfgs' (default), 'de'\n"
+	"\t--population         <val>              Differential evolution population size\n"
+	"\t--seed               <val>              Random seed\n"
+	"\t--checkpoint         <file>             Save and resume the population each generation\n"
+	"\t--grid               <val>              Coarse grid points per axis, search (default 5)\n"
+	"\t--depth              <val>              Refinement levels, search (default 4)\n"
+	"\nFit Control:\n"
+	"\t**the fitting grid is --wavelength, or the measured wavelengths if omitted\n"
+	"\t--measured           <file|dir>         Measured spectra, 'wavelength,value' text or binary records\n"
+	"\t--measured-r                            Measured spectrum is reflection (default transmission)\n"
+	"\t--fit-params         <name>[,...]       Any of period,n1,n2,width,loss (default period,n1,n2,loss)\n"
+	"\nUncertainty Control:\n"
+	"\t**the nominal design is the first value of each parameter\n"
+	"\t--vary               <var>:normal:<sigma>      Normal offset of a variable, repeatable\n"
+	"\t--vary               <var>:uniform:<lo>:<hi>   Uniform offset of a variable, repeatable\n"
+	"\t                     var: period,dutycycle,w1,w2,n1,n2,loss\n"
+	"\t--samples            <val>              Number of samples\n"
+	"\t--quantiles          <val>[,...]        Reported quantiles (default 0.05,0.5,0.95)\n"
+	"\t--order              <val>              Total degree of the chaos expansion, uq (default 2)\n"
+	"\t--level              <val>              Sparse grid level, uq (default 2)\n"
+	"\nExecution Control:\n"
+	"\t--threads            <val>              Worker threads, 0 for all cores (default)\n"
+	"\t-o, --output         <file>             Write results to a file instead of standard output\n"
+	"\t--writer             <type>             Bragg sweep output writer: 'write' (default), 'uring'\n"
+	"\t--direct                                Open --output with O_DIRECT, bragg sweeps\n"
+	"\t--shm-output         <name>             Publish bragg sweep records to a shared memory ring\n"
+	"\t                                        read with tmm-shm-consumer, see inc/shm.h\n"
+	"\t--shm-replace                           Replace an existing ring of the --shm-output name\n";
+
+/**
+ * \brief Header of the selected optional sweep columns
+ * 
+ * \param columns column_t flags
+ */
+static void 
+print_column_header(uint16_t columns)
+{
+	std::string text;
+	format_column_header(text, columns);
+	fputs(text.c_str(), stdout);
+}
+
+/**
+ * \brief Selected optional sweep columns of one row, values in column_names order
+ */
+static void 
+print_columns(uint16_t columns, std::initializer_list<double> values)
+{
+	std::string text;
+	format_columns(text, columns, values);
+	fputs(text.c_str(), stdout);
+}
+
+/**
+ * \brief Header of the scattering parameter columns
+ */
+static void 
+print_sparameter_header(sparameter_format_t format)
+{
+	std::string text;
+	format_sparameter_header(text, format);
+	fputs(text.c_str(), stdout);
+}
+
+/**
+ * \brief Scattering parameter columns of one row
+ */
+static void 
+print_sparameters(sparameter_format_t format, const sparameters& S)
+{
+	std::string text;
+	format_sparameters(text, format, S);
+	fputs(text.c_str(), stdout);
+}
 
 int main(int argc, char* argv[])
 {
 	std::unique_ptr<ctl> ctx = std::make_unique<ctl>();
+	bool group_delay_selected = false; // named in --columns
+
+	// Optional leading task
+	if (argc > 1 && argv[1][0] != '-')
+	{
+		string task{argv[1]};
+		if (task == "sweep")
+			ctx->task = SWEEP;
+		else if (task == "optimize")
+			ctx->task = OPTIMIZE;
+		else if (task == "fit")
+			ctx->task = FIT;
+		else if (task == "fit-batch")
+			ctx->task = FIT_BATCH;
+		else if (task == "montecarlo")
+			ctx->task = MONTECARLO;
+		else if (task == "uq")
+			ctx->task = UQ;
+		else if (task == "search")
+			ctx->task = SEARCH;
+		else if (task == "pareto")
+			ctx->task = PARETO;
+		else if (task == "field")
+			ctx->task = FIELD;
+		else if (task == "dfb")
+			ctx->task = DFB;
+		else if (task == "kerr")
+			ctx->task = KERR;
+		else if (task == "pulse")
+			ctx->task = PULSE;
+		else if (task == "vectfit")
+			ctx->task = VECTFIT;
+		else
+		{
+			cerr << "[ERROR] parsing: unknown task '" << task << "'" << endl;
+			cerr << usage << endl;
+			return -1;
+		}
+		argv++;
+		argc--;
+	}
 
 	try // Parsing CLI
 	{
@@ -79,6 +265,56 @@ int main(int argc, char* argv[])
 			{"n1-width-model",	required_argument, 0, 8},
 			{"n2-width-model",	required_argument, 0, 9},
 			{"dl",				required_argument, 0, 10},
+			{"sections",		required_argument, 0, 11},
+			{"iterations",		required_argument, 0, 12},
+			{"r-min",			required_argument, 0, 13},
+			{"r-max",			required_argument, 0, 14},
+			{"t-min",			required_argument, 0, 15},
+			{"t-max",			required_argument, 0, 16},
+			{"weight",			required_argument, 0, 17},
+			{"method",			required_argument, 0, 18},
+			{"population",		required_argument, 0, 19},
+			{"seed",			required_argument, 0, 20},
+			{"checkpoint",		required_argument, 0, 21},
+			{"threads",			required_argument, 0, 22},
+			{"measured",		required_argument, 0, 23},
+			{"measured-r",		no_argument,       0, 24},
+			{"fit-params",		required_argument, 0, 25},
+			{"vary",			required_argument, 0, 26},
+			{"samples",			required_argument, 0, 27},
+			{"quantiles",		required_argument, 0, 28},
+			{"disorder-width",	required_argument, 0, 29},
+			{"disorder-duty",	required_argument, 0, 30},
+			{"correlation-length", required_argument, 0, 31},
+			{"realizations",	required_argument, 0, 32},
+			{"order",			required_argument, 0, 33},
+			{"level",			required_argument, 0, 34},
+			{"sampling",		required_argument, 0, 35},
+			{"grid",			required_argument, 0, 36},
+			{"depth",			required_argument, 0, 37},
+			{"profile",			required_argument, 0, 38},
+			{"decimate",		required_argument, 0, 39},
+			{"sparams",			no_argument,       0, 40},
+			{"complex",			no_argument,       0, 41},
+			{"gain",			required_argument, 0, 42},
+			{"kerr",			required_argument, 0, 43},
+			{"power",			required_argument, 0, 44},
+			{"steps",			required_argument, 0, 45},
+			{"pulse-width",		required_argument, 0, 46},
+			{"carrier",			required_argument, 0, 47},
+			{"fft-size",		required_argument, 0, 48},
+			{"pad",				required_argument, 0, 49},
+			{"window",			required_argument, 0, 50},
+			{"poles",			required_argument, 0, 51},
+			{"linewidth",		required_argument, 0, 52},
+			{"lineshape",		required_argument, 0, 53},
+			{"columns",			required_argument, 0, 54},
+			{"explain",			no_argument,       0, 55},
+			{"output",			required_argument, 0, 'o'},
+			{"writer",			required_argument, 0, 56},
+			{"direct",			no_argument,       0, 57},
+			{"shm-output",		required_argument, 0, 58},
+			{"shm-replace",		no_argument,       0, 59},
 			{"help",			no_argument,       0, 'h'},
 			{0, 0, 0, 0}
 		};
@@ -86,7 +322,7 @@ int main(int argc, char* argv[])
 		int c;
 		int option_index = 0;
 		
-		while ((c = getopt_long(argc, argv, "a:c:d:hl:N:p:", long_options, &option_index)) != -1) 
+		while ((c = getopt_long(argc, argv, "a:c:d:hl:N:o:p:", long_options, &option_index)) != -1) 
 		{
 			switch (c) 
 			{
@@ -219,6 +455,153 @@ int main(int argc, char* argv[])
 					ctx->dl = std::strtod(optarg, &end);
 					break;
 				}
+				case 11: // --sections
+				{
+					ctx->sections = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 12: // --iterations
+				{
+					ctx->iterations = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 13: // --r-min
+				{
+					parse_numeric<double>(optarg, ctx->target.R_min, 0.0, 1.0);
+					break;
+				}
+				case 14: // --r-max
+				{
+					parse_numeric<double>(optarg, ctx->target.R_max, 0.0, 1.0);
+					break;
+				}
+				case 15: // --t-min
+				{
+					parse_numeric<double>(optarg, ctx->target.T_min, 0.0, 1.0);
+					break;
+				}
+				case 16: // --t-max
+				{
+					parse_numeric<double>(optarg, ctx->target.T_max, 0.0, 1.0);
+					break;
+				}
+				case 17: // --weight
+				{
+					parse_numeric<double>(optarg, ctx->target.weight, 0.0);
+					break;
+				}
+				case 18: // --method
+				{
+					string method{optarg};
+					if (method == "lbfgs")
+						ctx->optimizer = LBFGS;
+					else if (method == "de")
+						ctx->optimizer = DE;
+					else
+						throw std::runtime_error("unknown optimizer '" + method + "'");
+					break;
+				}
+				case 19: // --population
+				{
+					ctx->population = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 20: // --seed
+				{
+					ctx->seed = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 21: // --checkpoint
+				{
+					ctx->checkpoint = optarg;
+					break;
+				}
+				case 22: // --threads
+				{
+					ctx->threads = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 23: // --measured
+				{
+					ctx->measured = optarg;
+					break;
+				}
+				case 24: // --measured-r
+				{
+					ctx->measured_reflection = true;
+					break;
+				}
+				case 25: // --fit-params
+				{
+					const char* names[FIT_SIZE] = {"period", "n1", "n2", "width", "loss"};
+					ctx->fit_parameters.clear();
+					
+					string list{optarg};
+					size_t start = 0;
+					while (start <= list.size())
+					{
+						size_t end = list.find(',', start);
+						if (end == string::npos) 
+							end = list.size();
+						
+						string name = list.substr(start, end - start);
+						auto it = std::find(std::begin(names), std::end(names), name);
+						if (it == std::end(names))
+							throw std::runtime_error("unknown fit parameter '" + name + "'");
+						
+						auto param = static_cast<fit_parameter_t>(it - std::begin(names));
+						if (std::find(ctx->fit_parameters.begin(), ctx->fit_parameters.end(), param) == ctx->fit_parameters.end())
+							ctx->fit_parameters.push_back(param);
+						
+						start = end + 1;
+					}
+					break;
+				}
+				case 26: // --vary
+				{
+					ctx->variations.push_back(parse_variation(optarg));
+					break;
+				}
+				case 27: // --samples
+				{
+					ctx->samples = std::strtoull(optarg, nullptr, 10);
+					break;
+				}
+				case 28: // --quantiles
+				{
+					parse_numeric<double>(optarg, ctx->quantiles, 0.0, 1.0);
+					break;
+				}
+				case 29: // --disorder-width
+				{
+					ctx->roughness.width = std::strtod(optarg, nullptr);
+					break;
+				}
+				case 30: // --disorder-duty
+				{
+					ctx->roughness.duty_cycle = std::strtod(optarg, nullptr);
+					break;
+				}
+				case 31: // --correlation-length
+				{
+					ctx->roughness.correlation_length = std::strtod(optarg, nullptr);
+					break;
+				}
+				case 32: // --realizations
+				{
+					ctx->realizations = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 33: // --order
+				{
+					ctx->order = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 34: // --level
+				{
+					ctx->level = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
 				case 'a': // --loss
 				{
 					std::vector<double> loss;
@@ -235,6 +618,187 @@ int main(int argc, char* argv[])
 					parse_numeric<double>(optarg, ctx->duty_cycles, 0.0, 1.0);
 					break;
 				}
+				case 35: // --sampling
+				{
+					string sampling{optarg};
+					if (sampling == "cartesian")
+						ctx->sampling = CARTESIAN;
+					else if (sampling == "sobol")
+						ctx->sampling = SOBOL;
+					else if (sampling == "lhs")
+						ctx->sampling = LHS;
+					else
+						throw std::runtime_error("unknown sampling '" + sampling + "'");
+					break;
+				}
+				case 36: // --grid
+				{
+					ctx->grid = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 37: // --depth
+				{
+					ctx->depth = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 38: // --profile
+				{
+					ctx->profile = optarg;
+					break;
+				}
+				case 39: // --decimate
+				{
+					ctx->decimate = std::strtoull(optarg, nullptr, 10);
+					break;
+				}
+				case 40: // --sparams
+				{
+					ctx->sparameters = SP_POLAR;
+					break;
+				}
+				case 41: // --complex
+				{
+					ctx->sparameters = SP_COMPLEX;
+					break;
+				}
+				case 42: // --gain
+				{
+					parse_numeric<double>(optarg, ctx->gain);
+					break;
+				}
+				case 43: // --kerr
+				{
+					ctx->kerr = std::strtod(optarg, nullptr);
+					break;
+				}
+				case 44: // --power
+				{
+					parse_numeric<double>(optarg, ctx->power, 0.0);
+					break;
+				}
+				case 45: // --steps
+				{
+					ctx->steps = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 46: // --pulse-width
+				{
+					ctx->pulse_width = std::strtod(optarg, nullptr);
+					break;
+				}
+				case 47: // --carrier
+				{
+					ctx->carrier = std::strtod(optarg, nullptr);
+					break;
+				}
+				case 48: // --fft-size
+				{
+					ctx->fft_size = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 49: // --pad
+				{
+					ctx->pad = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 50: // --window
+				{
+					string window{optarg};
+					if (window == "none")
+						ctx->window = WINDOW_NONE;
+					else if (window == "hann")
+						ctx->window = WINDOW_HANN;
+					else if (window == "tukey")
+						ctx->window = WINDOW_TUKEY;
+					else
+						throw std::runtime_error("unknown window '" + window + "'");
+					break;
+				}
+				case 51: // --poles
+				{
+					ctx->poles = std::strtoul(optarg, nullptr, 10);
+					break;
+				}
+				case 52: // --linewidth
+				{
+					ctx->linewidth = std::strtod(optarg, nullptr);
+					break;
+				}
+				case 53: // --lineshape
+				{
+					string shape{optarg};
+					if (shape == "gaussian")
+						ctx->lineshape = LINE_GAUSSIAN;
+					else if (shape == "lorentzian")
+						ctx->lineshape = LINE_LORENTZIAN;
+					else if (shape == "sinc2")
+						ctx->lineshape = LINE_SINC2;
+					else
+						throw std::runtime_error("unknown line shape '" + shape + "'");
+					break;
+				}
+				case 54: // --columns
+				{
+					ctx->columns = 0;
+					
+					string list{optarg};
+					size_t start = 0;
+					while (start <= list.size())
+					{
+						size_t end = list.find(',', start);
+						if (end == string::npos) 
+							end = list.size();
+						
+						string name = list.substr(start, end - start);
+						auto it = std::find_if(std::begin(column_names), std::end(column_names), 
+							[&](const auto& column) { return name == column.first; });
+						if (it == std::end(column_names))
+							throw std::runtime_error("unknown column '" + name + "'");
+						
+						ctx->columns |= it->second;
+						group_delay_selected |= it->second == COL_GROUP_DELAY;
+						start = end + 1;
+					}
+					break;
+				}
+				case 55: // --explain
+				{
+					ctx->explain = true;
+					break;
+				}
+				case 56: // --writer
+				{
+					string writer{optarg};
+					if (writer == "write")
+						ctx->writer = WRITER_WRITE;
+					else if (writer == "uring")
+						ctx->writer = WRITER_URING;
+					else
+						throw std::runtime_error("unknown writer '" + writer + "'");
+					break;
+				}
+				case 57: // --direct
+				{
+					ctx->direct = true;
+					break;
+				}
+				case 58: // --shm-output
+				{
+					ctx->shm_output = optarg;
+					if (!ctx->shm_output.starts_with('/'))
+						ctx->shm_output = "/" + ctx->shm_output;
+					break;
+				}
+				case 59: // --shm-replace
+				{
+					ctx->shm_replace = true;
+					break;
+				}
+				case 'o': // --output
+				{
+					ctx->output = optarg;
+					break;
+				}
 				case 'd': // --device
 				{
 					string device{optarg};
@@ -242,6 +806,16 @@ int main(int argc, char* argv[])
 					{
 						ctx->device = BRAGG;
 					} 
+					else if (device == "disordered")
+					{
+						ctx->device = DISORDERED;
+					}
+					else if (device == "profile")
+					{
+						ctx->device = PROFILE;
+					}
+					else
+						throw std::runtime_error("unknown device '" + device + "'");
 					break;
 				}
 				case 'l': // --wavelength
@@ -275,15 +849,185 @@ int main(int argc, char* argv[])
 	try // validation
 	{
 		// Set default values if not specified
-		if (ctx->wavelengths.empty()) 
+		if (ctx->wavelengths.empty() && ctx->task != FIT && ctx->task != FIT_BATCH) 
 		{
 			cerr << "[ERROR] setup: Must specify at least one wavelength" << endl;
 			return -1;
 		}
 
-		if(ctx->device != BRAGG) 
+		if(ctx->device != BRAGG && ctx->device != DISORDERED && ctx->device != PROFILE) 
+		{
+			cerr << "[ERROR] setup: supported devices: 'bragg', 'disordered', 'profile'." << endl;
+			return -1;
+		}
+
+		if (ctx->device == PROFILE && ctx->task != SWEEP)
+		{
+			cerr << "[ERROR] setup: profile: only supported by the sweep task" << endl;
+			return -1;
+		}
+
+		if (ctx->task == FIELD && ctx->device != BRAGG)
+		{
+			cerr << "[ERROR] setup: field: only supported for the bragg device" << endl;
+			return -1;
+		}
+
+		if (ctx->task == FIELD && ctx->decimate == 0)
 		{
-			cerr << "[ERROR] setup: supported devices: 'bragg'." << endl;
+			cerr << "[ERROR] setup: field: --decimate must be at least 1" << endl;
+			return -1;
+		}
+
+		if (ctx->task == DFB && ctx->device != BRAGG)
+		{
+			cerr << "[ERROR] setup: dfb: only supported for the bragg device" << endl;
+			return -1;
+		}
+
+		if (ctx->task == DFB && (ctx->gain.empty() || ctx->gain.size() > 2 || ctx->gain.back() <= 0
+			|| (ctx->gain.size() == 2 && ctx->gain[1] <= ctx->gain[0])))
+		{
+			cerr << "[ERROR] setup: dfb: --gain must be <max> or <min>,<max> with max > min" << endl;
+			return -1;
+		}
+
+		if (ctx->task == DFB && ctx->wavelengths.size() < 2)
+		{
+			cerr << "[ERROR] setup: dfb: --wavelength must give at least the two ends of the window" << endl;
+			return -1;
+		}
+
+		if (ctx->task == KERR && ctx->device != BRAGG)
+		{
+			cerr << "[ERROR] setup: kerr: only supported for the bragg device" << endl;
+			return -1;
+		}
+
+		if (ctx->task == KERR && (ctx->power.empty() || ctx->power.size() > 2 || ctx->power.back() <= 0
+			|| (ctx->power.size() == 2 && ctx->power[1] <= ctx->power[0])))
+		{
+			cerr << "[ERROR] setup: kerr: --power must be <max> or <min>,<max> with max > min" << endl;
+			return -1;
+		}
+
+		if (ctx->task == KERR && ctx->steps == 0)
+		{
+			cerr << "[ERROR] setup: kerr: --steps must be at least 1" << endl;
+			return -1;
+		}
+
+		if (ctx->task == KERR && ctx->kerr == 0)
+		{
+			cerr << "[WARN] setup: kerr: --kerr is 0, the grating is linear" << endl;
+		}
+
+		if (ctx->task == PULSE && ctx->device != BRAGG)
+		{
+			cerr << "[ERROR] setup: pulse: only supported for the bragg device" << endl;
+			return -1;
+		}
+
+		if (ctx->task == PULSE && ctx->wavelengths.size() < 2)
+		{
+			cerr << "[ERROR] setup: pulse: --wavelength must give at least the two ends of the window" << endl;
+			return -1;
+		}
+
+		if ((ctx->task == PULSE || ctx->task == VECTFIT) && !ctx->wavelengths.empty() 
+			&& *std::max_element(ctx->wavelengths.begin(), ctx->wavelengths.end()) < 0.01)
+		{
+			cerr << "[WARN] setup: " << (ctx->task == PULSE ? "pulse" : "vectfit") 
+				<< ": wavelengths are taken in um, frequencies in THz and times in ps" << endl;
+		}
+
+		if (ctx->task == PULSE && (ctx->pulse_width <= 0 || ctx->fft_size < 2 || ctx->pad == 0))
+		{
+			cerr << "[ERROR] setup: pulse: needs --pulse-width > 0, --fft-size >= 2 and --pad >= 1" << endl;
+			return -1;
+		}
+
+		if (ctx->task == VECTFIT && ctx->device != BRAGG)
+		{
+			cerr << "[ERROR] setup: vectfit: only supported for the bragg device" << endl;
+			return -1;
+		}
+
+		if (ctx->task == VECTFIT && (ctx->poles == 0 || ctx->wavelengths.size() < 2 * (ctx->poles + 1)))
+		{
+			cerr << "[ERROR] setup: vectfit: needs at least one pole and 2*(poles+1) wavelengths" << endl;
+			return -1;
+		}
+
+		if (ctx->columns != COL_ALL && ctx->task != SWEEP)
+		{
+			cerr << "[ERROR] setup: --columns is supported by sweeps" << endl;
+			return -1;
+		}
+
+		if (group_delay_selected && ctx->dl == 0)
+		{
+			cerr << "[ERROR] setup: --columns group_delay needs the wavelength interval --dl" << endl;
+			return -1;
+		}
+
+		if (ctx->explain && (ctx->task != SWEEP || ctx->device != BRAGG))
+		{
+			cerr << "[ERROR] setup: --explain is supported by sweeps of the bragg device" << endl;
+			return -1;
+		}
+
+		if ((ctx->writer != WRITER_WRITE || ctx->direct) && (ctx->task != SWEEP || ctx->device != BRAGG))
+		{
+			cerr << "[ERROR] setup: --writer and --direct are supported by sweeps of the bragg device" << endl;
+			return -1;
+		}
+
+		if (!ctx->shm_output.empty() && (ctx->task != SWEEP || ctx->device != BRAGG))
+		{
+			cerr << "[ERROR] setup: --shm-output is supported by sweeps of the bragg device" << endl;
+			return -1;
+		}
+
+		if (!ctx->shm_output.empty() && (!ctx->output.empty() || ctx->writer != WRITER_WRITE))
+		{
+			cerr << "[ERROR] setup: --shm-output replaces the text output, --output and --writer" << endl;
+			return -1;
+		}
+
+		if (ctx->direct && ctx->output.empty())
+		{
+			cerr << "[ERROR] setup: --direct needs an output file, --output" << endl;
+			return -1;
+		}
+
+		if (ctx->linewidth < 0 || (ctx->linewidth > 0 && (ctx->task != SWEEP || ctx->device != BRAGG)))
+		{
+			cerr << "[ERROR] setup: --linewidth must be positive and is supported by sweeps of the bragg device" << endl;
+			return -1;
+		}
+
+		if (ctx->sparameters != SP_NONE && (ctx->task != SWEEP || ctx->device == DISORDERED))
+		{
+			cerr << "[ERROR] setup: --sparams and --complex are supported by sweeps of the bragg and profile devices" << endl;
+			return -1;
+		}
+
+		if (ctx->device == PROFILE && ctx->profile.empty())
+		{
+			cerr << "[ERROR] setup: profile: Must specify the layer file with --profile" << endl;
+			return -1;
+		}
+
+		if (ctx->device == DISORDERED && ctx->task != SWEEP)
+		{
+			cerr << "[ERROR] setup: disordered: only supported by the sweep task" << endl;
+			return -1;
+		}
+
+		if (ctx->device == DISORDERED && ctx->realizations == 0)
+		{
+			cerr << "[ERROR] setup: disordered: Must specify at least one realization" << endl;
 			return -1;
 		}
 
@@ -292,47 +1036,137 @@ int main(int argc, char* argv[])
 			cerr << "[WARN] setup: group delay: wavelength interval=0, ignored" << endl;
 		}
 
-		if(ctx->dl != 0
+		if(ctx->dl != 0 && ctx->n1 && ctx->n2 && ctx->loss
 			&& (ctx->n1->sampled || ctx->n2->sampled || ctx->loss->sampled) ) 
 		{
 			cerr << "[WARN] setup: group delay: not supported for sampled data" << endl;
 		}
 	
-		if (ctx->device == BRAGG && ctx->periods.empty())
+		if ((ctx->device == BRAGG || ctx->device == DISORDERED) && ctx->periods.empty())
 		{
 			cerr << "[ERROR] setup: bragg: Must specify at least one period" << endl;
 			return -1;
 		}
 
-		if (ctx->device == BRAGG && ctx->duty_cycles.empty()) 
+		if ((ctx->device == BRAGG || ctx->device == DISORDERED) && ctx->duty_cycles.empty()) 
 		{
 			cerr << "[ERROR] setup: bragg: Must specify dutycycle" << endl;
 			return -1;
 		}
 		
-		if (ctx->device == BRAGG && ctx->Ns.empty()) 
+		if ((ctx->device == BRAGG || ctx->device == DISORDERED) && ctx->Ns.empty()) 
 		{
 			cerr << "[ERROR] setup: bragg: Must specify number of gratings" << endl;
 			return -1;
 		}
 
-		if (ctx->device == BRAGG && !ctx->n1)
+		if ((ctx->device == BRAGG || ctx->device == DISORDERED) && !ctx->n1)
 		{
 			cerr << "[ERROR] setup: bragg: Must specify n1 with --n1 or --n1-model" << endl;
 			return -1;
 		}
 
-		if (ctx->device == BRAGG && !ctx->n2)
+		if ((ctx->device == BRAGG || ctx->device == DISORDERED) && !ctx->n2)
 		{
 			cerr << "[ERROR] setup: bragg: Must specify n2 with --n2 or --n2-model" << endl;
 			return -1;
 		}
 
-		if (ctx->device == BRAGG && !ctx->loss)
+		if ((ctx->device == BRAGG || ctx->device == DISORDERED) && !ctx->loss)
 		{
 			cerr << "[ERROR] setup: bragg: Must specify loss with --loss or --loss-model" << endl;
 			return -1;
 		}
+
+		if (ctx->linewidth > 0 && (ctx->n1->sampled || ctx->n2->sampled || ctx->loss->sampled))
+		{
+			cerr << "[ERROR] setup: --linewidth: sampled material data is not supported, use constants or models" << endl;
+			return -1;
+		}
+
+		if (ctx->task == PULSE && (ctx->n1->sampled || ctx->n2->sampled || ctx->loss->sampled))
+		{
+			cerr << "[ERROR] setup: pulse: sampled material data is not supported, use constants or models" << endl;
+			return -1;
+		}
+
+		if (ctx->task == DFB && (ctx->n1->sampled || ctx->n2->sampled || ctx->loss->sampled))
+		{
+			cerr << "[ERROR] setup: dfb: sampled material data is not supported, use constants or models" << endl;
+			return -1;
+		}
+
+		if (ctx->task == OPTIMIZE && ctx->target.empty())
+		{
+			cerr << "[ERROR] setup: optimize: Must specify a spectral mask with --r-min, --r-max, --t-min or --t-max" << endl;
+			return -1;
+		}
+
+		if (ctx->task == SEARCH && ctx->target.empty())
+		{
+			cerr << "[ERROR] setup: search: Must specify a spectral mask with --r-min, --r-max, --t-min or --t-max" << endl;
+			return -1;
+		}
+
+		if (ctx->task == SEARCH && (ctx->grid < 2 || ctx->depth > 20))
+		{
+			cerr << "[ERROR] setup: search: --grid must be at least 2 and --depth at most 20" << endl;
+			return -1;
+		}
+
+		if (ctx->task == OPTIMIZE && ctx->optimizer == DE && ctx->population && ctx->population < 4)
+		{
+			cerr << "[ERROR] setup: optimize: differential evolution needs a population of at least 4" << endl;
+			return -1;
+		}
+
+		if ((ctx->task == FIT || ctx->task == FIT_BATCH) && ctx->measured.empty())
+		{
+			cerr << "[ERROR] setup: fit: Must specify a measured spectrum with --measured" << endl;
+			return -1;
+		}
+
+		if ((ctx->task == FIT || ctx->task == FIT_BATCH) && ctx->wavelengths.empty() 
+			&& (ctx->n1->sampled || ctx->n2->sampled || ctx->loss->sampled) )
+		{
+			cerr << "[ERROR] setup: fit: sampled data requires the fitting grid --wavelength" << endl;
+			return -1;
+		}
+
+		if ((ctx->task == SWEEP || ctx->task == PARETO) && ctx->sampling != CARTESIAN && ctx->samples == 0)
+		{
+			cerr << "[ERROR] setup: sampling: Must specify the number of designs with --samples" << endl;
+			return -1;
+		}
+
+		if (ctx->task == MONTECARLO && ctx->samples == 0)
+		{
+			cerr << "[ERROR] setup: montecarlo: Must specify the number of samples with --samples" << endl;
+			return -1;
+		}
+
+		if (ctx->task == MONTECARLO && ctx->variations.empty())
+		{
+			cerr << "[WARN] setup: montecarlo: no --vary given, every sample is the nominal design" << endl;
+		}
+
+		if (ctx->task == UQ && ctx->variations.empty())
+		{
+			cerr << "[ERROR] setup: uq: Must specify at least one --vary" << endl;
+			return -1;
+		}
+
+		if (ctx->task == UQ && ctx->level == 0)
+		{
+			cerr << "[ERROR] setup: uq: --level must be at least 1" << endl;
+			return -1;
+		}
+
+		if (ctx->task == OPTIMIZE && ctx->sections == 0)
+		{
+			cerr << "[ERROR] setup: optimize: Must specify at least one section" << endl;
+			return -1;
+		}
 	}
 	catch(const exception& ex)
 	{
@@ -342,90 +1176,152 @@ int main(int argc, char* argv[])
 
 	try // Running the simulation
 	{
+		// Bragg sweeps open their own sink
+		if (!ctx->output.empty() && !(ctx->task == SWEEP && ctx->device == BRAGG && !ctx->explain)
+			&& !freopen(ctx->output.c_str(), "w", stdout))
+			throw std::runtime_error("open " + ctx->output + ": " + std::strerror(errno));
+
+		if (ctx->task == OPTIMIZE)
+			return optimize(*ctx);
+
+		if (ctx->task == FIT)
+			return fit(*ctx);
+
+		if (ctx->task == FIT_BATCH)
+			return fit_batch(*ctx);
+
+		if (ctx->task == MONTECARLO)
+			return montecarlo(*ctx);
+
+		if (ctx->task == UQ)
+			return uq(*ctx);
+
+		if (ctx->task == SEARCH)
+			return search(*ctx);
+
+		if (ctx->task == PARETO)
+			return pareto(*ctx);
+
+		if (ctx->task == FIELD)
+			return field(*ctx);
+
+		if (ctx->task == DFB)
+			return dfb(*ctx);
+
+		if (ctx->task == KERR)
+			return kerr(*ctx);
+
+		if (ctx->task == PULSE)
+			return pulse(*ctx);
+
+		if (ctx->task == VECTFIT)
+			return vectfit(*ctx);
+
 		if (ctx->device == BRAGG)
+			return sweep(*ctx);
+
+		if (ctx->device == DISORDERED)
 		{
 			bool sweep_width1 = !ctx->width1.empty();
 			bool sweep_width2 = !ctx->width2.empty();
-			bool analyze_group_delay = ctx->dl;
+			const size_t W = ctx->wavelengths.size();
 			
 			printf("period,duty_cycle,N,wavelength");
 			if (sweep_width1) printf(",w1");
 			if (sweep_width2) printf(",w2");
-			printf(",n1,n2,loss,R,T,phase_r,phase_t");
-			if (ctx->dl) printf(",group_delay");
+			uint16_t columns = ctx->columns & (COL_N1 | COL_N2 | COL_LOSS | COL_R | COL_T);
+			print_column_header(columns);
+			if (columns & COL_R) printf(",R_std");
+			if (columns & COL_T) printf(",T_std");
 			printf("\n");
 
-			for (const auto& period : ctx->periods)
+			const auto points = designs(*ctx);
+			for (size_t i = 0; i < points.size(); ++i)
 			{
-				for (const auto& duty_cycle : ctx->duty_cycles)
+				const auto [period, duty_cycle, N, w1, w2] = points[i];
+
+				// Ensemble moments over the realizations (Welford)
+				std::vector<double> R_mean(W, 0.0), R_m2(W, 0.0), T_mean(W, 0.0), T_m2(W, 0.0);
+
+				for (size_t realization = 0; realization < ctx->realizations; ++realization)
 				{
-					for (const auto& N : ctx->Ns)
+					Disordered grating(period, duty_cycle, N, ctx->roughness, ctx->seed, realization);
+
+					size_t idx = 0;
+					for (const auto& wavelength : ctx->wavelengths)
 					{
-						Bragg grating(period, duty_cycle, N);
-
-						const auto& w1_list = sweep_width1 ? ctx->width1 : std::vector<double>{0.0};
-						const auto& w2_list = sweep_width2 ? ctx->width2 : std::vector<double>{0.0};
-
-						for (const auto& w1 : w1_list)
-						{
-							for (const auto& w2 : w2_list)
-							{
-								size_t idx = 0;
-								for (const auto& wavelength : ctx->wavelengths)
-								{
-									double n1_val = (*ctx->n1)(wavelength, w1, idx);
-									double n2_val = (*ctx->n2)(wavelength, w2, idx);
-									double loss_val = (*ctx->loss)(wavelength, 0.0, idx);
-									double gdelay_val = 0;
-
-									// Compute reflection and transmission
-									auto [R, T, r, t] = grating.scattering_coefficients(
-										wavelength,
-										n1_val, 
-										n2_val, 
-										loss_val
-									);
-									
-									//todo: support sampled data
-									if( analyze_group_delay 
-										&& !ctx->n1->sampled 
-											&& !ctx->n2->sampled 
-												&& !ctx->loss->sampled)
-									{
-										auto dwb = wavelength - ctx->dl; //backward difference
-										auto dwf = wavelength + ctx->dl; //forward difference
-
-										auto [Rb, Tb, rb, tb] = grating.scattering_coefficients(
-											dwb, 
-											(*ctx->n1)(dwb, w1, idx), 
-											(*ctx->n2)(dwb, w2, idx), 
-											loss_val
-										);
-
-										auto [Rf, Tf, rf, tf] = grating.scattering_coefficients(
-											dwf,
-											(*ctx->n1)(dwf, w1, idx), 
-											(*ctx->n2)(dwf, w2, idx), 
-											loss_val
-										);
-										//group delay of transmission 
-										gdelay_val = group_delay(tb, tf, dwb, dwf);
-									}
-
-									// Print results
-									printf("%.6g,%.6g,%.6g,%.6g", period, duty_cycle, N, wavelength);
-									if (sweep_width1) printf(",%.6g", w1);
-									if (sweep_width2) printf(",%.6g", w2);
-									printf(",%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g", n1_val, n2_val, loss_val, R, T, r, t);
-									if (analyze_group_delay) printf(",%.6g", gdelay_val);
-									printf("\n");
-
-									idx++;
-								}
-							}
-						}
+						auto [R, T, r, t] = grating.scattering_coefficients(
+							wavelength,
+							*ctx->n1, 
+							*ctx->n2, 
+							w1, 
+							w2,
+							(*ctx->loss)(wavelength, 0.0, idx),
+							idx,
+							ctx->threads
+						);
+
+						const double dR = R - R_mean[idx];
+						const double dT = T - T_mean[idx];
+						R_mean[idx] += dR / (realization + 1);
+						T_mean[idx] += dT / (realization + 1);
+						R_m2[idx] += dR * (R - R_mean[idx]);
+						T_m2[idx] += dT * (T - T_mean[idx]);
+						idx++;
 					}
 				}
+
+				const double n = static_cast<double>(ctx->realizations);
+
+				size_t idx = 0;
+				for (const auto& wavelength : ctx->wavelengths)
+				{
+					printf("%.6g,%.6g,%.6g,%.6g", period, duty_cycle, N, wavelength);
+					if (sweep_width1) printf(",%.6g", w1);
+					if (sweep_width2) printf(",%.6g", w2);
+					print_columns(columns, {
+						(*ctx->n1)(wavelength, w1, idx), 
+						(*ctx->n2)(wavelength, w2, idx), 
+						(*ctx->loss)(wavelength, 0.0, idx), 
+						R_mean[idx], T_mean[idx]});
+					if (columns & COL_R) printf(",%.6g", std::sqrt(R_m2[idx] / n));
+					if (columns & COL_T) printf(",%.6g", std::sqrt(T_m2[idx] / n));
+					printf("\n");
+
+					idx++;
+				}
+			}
+		}
+		else if (ctx->device == PROFILE)
+		{
+			Profile profile(ctx->profile);
+			
+			cerr << "[INFO] profile: " << profile.layers() << " layers, " << profile.elements() << " distinct, " 
+				<< profile.groups() << " groups, " << profile.segments() << " segments" << endl;
+			
+			uint16_t columns = ctx->columns & (COL_R | COL_T | COL_PHASE_R | COL_PHASE_T);
+			
+			printf("wavelength");
+			print_column_header(columns);
+			print_sparameter_header(ctx->sparameters);
+			printf("\n");
+			
+			for (const auto& wavelength : ctx->wavelengths)
+			{
+				if (ctx->sparameters != SP_NONE)
+				{
+					auto S = profile.scattering_parameters(wavelength, ctx->threads);
+					printf("%.6g", wavelength);
+					print_columns(columns, {NAN, NAN, NAN, std::norm(S.S11), std::norm(S.S21), std::arg(S.S11), std::arg(S.S21)});
+					print_sparameters(ctx->sparameters, S);
+					printf("\n");
+					continue;
+				}
+				
+				auto [R, T, r, t] = profile.scattering_coefficients(wavelength, ctx->threads);
+				printf("%.6g", wavelength);
+				print_columns(columns, {NAN, NAN, NAN, R, T, r, t});
+				printf("\n");
 			}
 		}
 	}
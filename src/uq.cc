@@ -0,0 +1,372 @@
+/**
+ * \file uq.cc
+ * \brief implementations for uq.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <uq.h>
+#include <montecarlo.h>
+#include <linalg.h>
+#include <rng.h>
+#include <pool.h>
+#include <iostream>
+#include <algorithm>
+#include <map>
+
+namespace tmm
+{
+	namespace
+	{
+		/**
+		 * \brief Gauss rule of m points for the distribution of a variation, on the standard variable
+		 */
+		void 
+		gauss_rule(distribution_t distribution, size_t m, std::vector<double>& nodes, std::vector<double>& weights)
+		{
+			// Golub-Welsch on the Jacobi matrix of the orthogonal polynomials
+			std::vector<double> e(m, 0.0);
+			nodes.assign(m, 0.0);
+			
+			for (size_t n = 1; n < m; ++n)
+				e[n] = distribution == NORMAL ? std::sqrt(static_cast<double>(n)) : n / std::sqrt(4.0 * n * n - 1.0);
+			
+			tridiagonal_eigen(nodes, e, weights);
+			
+			for (auto& w : weights)
+				w *= w;
+		}
+
+		/**
+		 * \brief Orthogonal polynomials of degree 0..p at x: probabilists' Hermite or Legendre
+		 */
+		void 
+		polynomials(distribution_t distribution, double x, size_t p, double* out)
+		{
+			out[0] = 1.0;
+			if (p > 0)
+				out[1] = x;
+			
+			for (size_t n = 1; n < p; ++n)
+				out[n + 1] = distribution == NORMAL 
+					? x * out[n] - n * out[n - 1]
+					: ((2.0 * n + 1.0) * x * out[n] - n * out[n - 1]) / (n + 1.0);
+		}
+
+		/**
+		 * \brief Squared norm of the degree n polynomial under the distribution
+		 */
+		double 
+		norm(distribution_t distribution, size_t n)
+		{
+			if (distribution == NORMAL)
+			{
+				double f = 1.0;
+				for (size_t k = 2; k <= n; ++k)
+					f *= k;
+				return f;
+			}
+			return 1.0 / (2.0 * n + 1.0);
+		}
+
+		/**
+		 * \brief Multi-indices of dimension d with entries >= lo and sum in [min, max]
+		 */
+		void 
+		multi_indices(size_t d, size_t lo, size_t min, size_t max, std::vector<size_t>& current, std::vector<std::vector<size_t>>& out)
+		{
+			size_t sum = 0;
+			for (auto v : current)
+				sum += v;
+			
+			if (current.size() == d)
+			{
+				if (sum >= min && sum <= max)
+					out.push_back(current);
+				return;
+			}
+			
+			for (size_t v = lo; sum + v + lo * (d - current.size() - 1) <= max; ++v)
+			{
+				current.push_back(v);
+				multi_indices(d, lo, min, max, current, out);
+				current.pop_back();
+			}
+		}
+
+		size_t 
+		binomial(size_t n, size_t k)
+		{
+			if (k > n)
+				return 0;
+			size_t r = 1;
+			for (size_t i = 1; i <= k; ++i)
+				r = r * (n - k + i) / i;
+			return r;
+		}
+
+		/**
+		 * \brief Distinct nodes of the Smolyak sparse grid of level q on the standard variables
+		 */
+		std::vector<std::vector<double>> 
+		sparse_grid(const std::vector<variation>& variations, size_t q)
+		{
+			const size_t d = variations.size();
+			const size_t L = q + d;
+			
+			std::vector<std::vector<size_t>> levels;
+			std::vector<size_t> current;
+			multi_indices(d, 1, L > 2 * d - 1 ? L - d + 1 : d, L, current, levels);
+			
+			std::map<std::vector<double>, bool> grid;
+			
+			for (const auto& level : levels)
+			{
+				size_t sum = 0;
+				for (auto l : level)
+					sum += l;
+				
+				// Tensor grids with a zero combination coefficient do not contribute
+				if (binomial(d - 1, L - sum) == 0)
+					continue;
+				
+				std::vector<std::vector<double>> rules(d);
+				std::vector<double> w;
+				for (size_t k = 0; k < d; ++k)
+					gauss_rule(variations[k].distribution, 2 * level[k] - 1, rules[k], w);
+				
+				std::vector<size_t> at(d, 0);
+				while (true)
+				{
+					std::vector<double> x(d);
+					for (size_t k = 0; k < d; ++k)
+					{
+						// Symmetric rules put the centre node at a rounding-level offset from 0
+						x[k] = std::abs(rules[k][at[k]]) < 1e-12 ? 0.0 : rules[k][at[k]];
+					}
+					grid[x] = true;
+					
+					size_t k = 0;
+					for (; k < d; ++k)
+					{
+						if (++at[k] < rules[k].size())
+							break;
+						at[k] = 0;
+					}
+					if (k == d)
+						break;
+				}
+			}
+			
+			std::vector<std::vector<double>> nodes;
+			for (const auto& [x, _] : grid)
+				nodes.push_back(x);
+			return nodes;
+		}
+
+		/**
+		 * \brief Offsets of the design variables at a point of the standard variables
+		 */
+		offset_vector 
+		offsets(const std::vector<variation>& variations, const std::vector<double>& x)
+		{
+			offset_vector offset{};
+			for (size_t k = 0; k < variations.size(); ++k)
+			{
+				const auto& v = variations[k];
+				// Uniform standard variables live on [-1, 1]
+				offset[v.variable] += v(x[k], (x[k] + 1.0) / 2.0);
+			}
+			return offset;
+		}
+
+		/**
+		 * \brief Values of every basis polynomial at a point
+		 */
+		std::vector<double> 
+		basis(const std::vector<variation>& variations, const std::vector<std::vector<size_t>>& alphas, size_t p, const std::vector<double>& x)
+		{
+			const size_t d = variations.size();
+			std::vector<double> table(d * (p + 1));
+			for (size_t k = 0; k < d; ++k)
+				polynomials(variations[k].distribution, x[k], p, &table[k * (p + 1)]);
+			
+			std::vector<double> phi(alphas.size(), 1.0);
+			for (size_t b = 0; b < alphas.size(); ++b)
+				for (size_t k = 0; k < d; ++k)
+					phi[b] *= table[k * (p + 1) + alphas[b][k]];
+			return phi;
+		}
+	}
+
+	int 
+	uq(const ctl& ctx)
+	{
+		const auto& variations = ctx.variations;
+		const size_t d = variations.size();
+		const size_t p = ctx.order;
+		const size_t W = ctx.wavelengths.size();
+		
+		// Total degree basis
+		std::vector<std::vector<size_t>> alphas;
+		std::vector<size_t> current;
+		multi_indices(d, 0, 0, p, current, alphas);
+		std::stable_sort(alphas.begin(), alphas.end(), [](const auto& a, const auto& b)
+		{
+			size_t sa = 0, sb = 0;
+			for (auto v : a) sa += v;
+			for (auto v : b) sb += v;
+			return sa < sb;
+		});
+		
+		const size_t B = alphas.size();
+		auto nodes = sparse_grid(variations, ctx.level);
+		const size_t M = nodes.size();
+		
+		if (M < B)
+		{
+			std::cerr << "[ERROR] uq: " << M << " sparse grid nodes cannot fit " << B 
+				<< " expansion terms, raise --level or lower --order" << std::endl;
+			return -1;
+		}
+		
+		std::cerr << "[INFO] uq: " << M << " solves for " << B << " expansion terms" << std::endl;
+		
+		// Solves at the nodes, node-major
+		std::vector<double> R(M * W), T(M * W);
+		parallel_for(M, [&](size_t i, size_t)
+		{
+			std::vector<double> R_, T_;
+			perturbed_spectrum(ctx, offsets(variations, nodes[i]), R_, T_);
+			std::copy(R_.begin(), R_.end(), R.begin() + i * W);
+			std::copy(T_.begin(), T_.end(), T.begin() + i * W);
+		}, ctx.threads);
+		
+		// Least squares c = (Phi^T Phi)^-1 Phi^T f, shared by every wavelength
+		std::vector<double> Phi(M * B), gram(B * B, 0.0);
+		for (size_t i = 0; i < M; ++i)
+		{
+			auto phi = basis(variations, alphas, p, nodes[i]);
+			std::copy(phi.begin(), phi.end(), Phi.begin() + i * B);
+		}
+		for (size_t i = 0; i < M; ++i)
+			for (size_t a = 0; a < B; ++a)
+				for (size_t b = 0; b < B; ++b)
+					gram[a * B + b] += Phi[i * B + a] * Phi[i * B + b];
+		
+		auto inverse = invert(gram, B);
+		
+		std::vector<double> norms(B, 1.0);
+		for (size_t b = 0; b < B; ++b)
+			for (size_t k = 0; k < d; ++k)
+				norms[b] *= norm(variations[k].distribution, alphas[b][k]);
+		
+		auto coefficients = [&](const std::vector<double>& f, size_t w)
+		{
+			std::vector<double> rhs(B, 0.0), c(B, 0.0);
+			for (size_t i = 0; i < M; ++i)
+				for (size_t a = 0; a < B; ++a)
+					rhs[a] += Phi[i * B + a] * f[i * W + w];
+			for (size_t a = 0; a < B; ++a)
+				for (size_t b = 0; b < B; ++b)
+					c[a] += inverse[a * B + b] * rhs[b];
+			return c;
+		};
+		
+		// Quantiles by sampling the surrogate
+		const size_t K = 10000;
+		const philox rng(ctx.seed);
+		std::vector<double> samples(K * B);
+		for (size_t s = 0; s < K; ++s)
+		{
+			std::vector<double> x(d);
+			for (size_t k = 0; k < d; ++k)
+				x[k] = variations[k].distribution == NORMAL ? rng.normal(s, k) : 2.0 * rng.uniform(s, k)[0] - 1.0;
+			auto phi = basis(variations, alphas, p, x);
+			std::copy(phi.begin(), phi.end(), samples.begin() + s * B);
+		}
+		
+		printf("wavelength");
+		for (const char* q : {"R", "T"})
+		{
+			printf(",%s_mean,%s_std", q, q);
+			for (auto v : ctx.quantiles) printf(",%s_q%g", q, v);
+			for (const auto& v : variations) printf(",%s_S_%s", q, variable_names[v.variable]);
+			for (const auto& v : variations) printf(",%s_ST_%s", q, variable_names[v.variable]);
+		}
+		printf("\n");
+		
+		for (size_t w = 0; w < W; ++w)
+		{
+			printf("%.6g", ctx.wavelengths[w]);
+			
+			for (const auto* f : {&R, &T})
+			{
+				auto c = coefficients(*f, w);
+				
+				double variance = 0;
+				std::vector<double> first(d, 0.0), total(d, 0.0);
+				
+				for (size_t b = 1; b < B; ++b)
+				{
+					const double v = c[b] * c[b] * norms[b];
+					variance += v;
+					
+					size_t active = 0, last = 0;
+					for (size_t k = 0; k < d; ++k)
+						if (alphas[b][k])
+						{
+							total[k] += v;
+							active++;
+							last = k;
+						}
+					if (active == 1)
+						first[last] += v;
+				}
+				
+				std::vector<double> values(K);
+				for (size_t s = 0; s < K; ++s)
+				{
+					double y = 0;
+					for (size_t b = 0; b < B; ++b)
+						y += c[b] * samples[s * B + b];
+					values[s] = y;
+				}
+				std::sort(values.begin(), values.end());
+				
+				printf(",%.6g,%.6g", c[0], std::sqrt(variance));
+				for (auto q : ctx.quantiles)
+					printf(",%.6g", values[std::min(static_cast<size_t>(q * K), K - 1)]);
+				for (size_t k = 0; k < d; ++k)
+					printf(",%.6g", variance > 0 ? first[k] / variance : 0.0);
+				for (size_t k = 0; k < d; ++k)
+					printf(",%.6g", variance > 0 ? total[k] / variance : 0.0);
+			}
+			printf("\n");
+		}
+		
+		return 0;
+	}
+}//namespace tmm
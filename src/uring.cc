@@ -0,0 +1,332 @@
+/**
+ * \file uring.cc
+ * \brief io_uring output sink
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <uring.h>
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+
+namespace tmm
+{
+	namespace
+	{
+		constexpr size_t alignment = 4096; ///< buffer and O_DIRECT alignment
+
+		int io_uring_setup(unsigned entries, io_uring_params* params)
+		{
+			return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+		}
+
+		int io_uring_enter(int ring, unsigned submit, unsigned complete, unsigned flags)
+		{
+			return static_cast<int>(syscall(__NR_io_uring_enter, ring, submit, complete, flags, nullptr, 0));
+		}
+
+		int io_uring_register(int ring, unsigned opcode, void* arg, unsigned count)
+		{
+			return static_cast<int>(syscall(__NR_io_uring_register, ring, opcode, arg, count));
+		}
+
+		[[noreturn]] void fail(const std::string& what, int error)
+		{
+			throw std::runtime_error("io_uring: " + what + ": " + std::strerror(error));
+		}
+
+		/**
+		 * \brief Pointer to the ring field at byte offset `offset` of a mapping
+		 */
+		template<typename T>
+		T* field(void* map, unsigned offset)
+		{
+			return reinterpret_cast<T*>(static_cast<char*>(map) + offset);
+		}
+	}
+
+	uring_sink::uring_sink(int fd, bool owned, size_t capacity, size_t depth) : 
+	_fd(fd), _owned(owned), _capacity(capacity), _buffers(depth), _current(depth)
+	{
+		if (capacity == 0 || capacity % alignment || depth == 0)
+			throw std::invalid_argument("io_uring: buffers must be a positive multiple of 4096 bytes");
+		
+		const int flags = fcntl(fd, F_GETFL);
+		_direct = flags != -1 && (flags & O_DIRECT);
+		_offset = lseek(fd, 0, SEEK_CUR);
+		_seekable = _offset != -1;
+		if (!_seekable)
+			_offset = 0;
+		
+		io_uring_params params{};
+		_ring = io_uring_setup(static_cast<unsigned>(depth), &params);
+		if (_ring < 0)
+			fail("setup", errno);
+		
+		try
+		{
+			// Asynchronous writes need IORING_OP_WRITE, Linux 5.6
+			std::vector<char> storage(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op));
+			auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+			if (io_uring_register(_ring, IORING_REGISTER_PROBE, probe, 256) < 0)
+				fail("probe", errno);
+			if (probe->last_op < IORING_OP_WRITE || !(probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED))
+				fail("write", EOPNOTSUPP);
+			
+			_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+			_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			if (params.features & IORING_FEAT_SINGLE_MMAP)
+				_sq_size = _cq_size = std::max(_sq_size, _cq_size);
+			
+			_sq_map = mmap(nullptr, _sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+			if (_sq_map == MAP_FAILED)
+				fail("mmap", errno);
+			
+			_cq_map = _sq_map;
+			if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+			{
+				_cq_map = mmap(nullptr, _cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+				if (_cq_map == MAP_FAILED)
+					fail("mmap", errno);
+			}
+			
+			_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+			void* sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES);
+			if (sqes == MAP_FAILED)
+				fail("mmap", errno);
+			_sqes = static_cast<io_uring_sqe*>(sqes);
+			
+			_sq_tail = field<unsigned>(_sq_map, params.sq_off.tail);
+			_sq_mask = field<unsigned>(_sq_map, params.sq_off.ring_mask);
+			_sq_array = field<unsigned>(_sq_map, params.sq_off.array);
+			_cq_head = field<unsigned>(_cq_map, params.cq_off.head);
+			_cq_tail = field<unsigned>(_cq_map, params.cq_off.tail);
+			_cq_mask = field<unsigned>(_cq_map, params.cq_off.ring_mask);
+			_cqes = field<io_uring_cqe>(_cq_map, params.cq_off.cqes);
+			
+			for (size_t i = 0; i < depth; ++i)
+			{
+				_buffers[i].data.reset(static_cast<char*>(std::aligned_alloc(alignment, capacity)));
+				if (!_buffers[i].data)
+					throw std::bad_alloc();
+				_free.push_back(depth - 1 - i);
+			}
+		}
+		catch (...)
+		{
+			if (_sqes)
+				munmap(_sqes, _sqes_size);
+			if (_cq_map && _cq_map != MAP_FAILED && _cq_map != _sq_map)
+				munmap(_cq_map, _cq_size);
+			if (_sq_map && _sq_map != MAP_FAILED)
+				munmap(_sq_map, _sq_size);
+			close(_ring);
+			throw;
+		}
+	}
+
+	uring_sink::~uring_sink()
+	{
+		// The kernel may still read buffers in flight
+		try
+		{
+			drain();
+		}
+		catch (...)
+		{
+		}
+		
+		munmap(_sqes, _sqes_size);
+		if (_cq_map != _sq_map)
+			munmap(_cq_map, _cq_size);
+		munmap(_sq_map, _sq_size);
+		close(_ring);
+		
+		if (_owned)
+			close(_fd);
+	}
+
+	void uring_sink::enqueue(size_t i)
+	{
+		auto& b = _buffers[i];
+		const unsigned tail = *_sq_tail;
+		const unsigned index = tail & *_sq_mask;
+		
+		io_uring_sqe& sqe = _sqes[index];
+		std::memset(&sqe, 0, sizeof sqe);
+		sqe.opcode = IORING_OP_WRITE;
+		sqe.fd = _fd;
+		sqe.addr = reinterpret_cast<uint64_t>(b.data.get() + b.done);
+		sqe.len = static_cast<uint32_t>(b.size - b.done);
+		sqe.off = _seekable ? static_cast<uint64_t>(b.offset + b.done) : static_cast<uint64_t>(-1);
+		sqe.user_data = i;
+		
+		_sq_array[index] = index;
+		std::atomic_ref<unsigned>(*_sq_tail).store(tail + 1, std::memory_order_release);
+		
+		int submitted;
+		while ((submitted = io_uring_enter(_ring, 1, 0, 0)) < 0 && errno == EINTR)
+			;
+		if (submitted < 0)
+			fail("enter", errno);
+	}
+
+	void uring_sink::submit(size_t i)
+	{
+		// Writes without offsets complete in any order, so only one is in flight
+		if (!_seekable)
+			drain();
+		
+		auto& b = _buffers[i];
+		b.done = 0;
+		b.offset = _offset;
+		_offset += b.size;
+		++_in_flight;
+		enqueue(i);
+	}
+
+	void uring_sink::reap(bool wait)
+	{
+		if (wait)
+		{
+			int result;
+			while ((result = io_uring_enter(_ring, 0, 1, IORING_ENTER_GETEVENTS)) < 0 && errno == EINTR)
+				;
+			if (result < 0)
+				fail("enter", errno);
+		}
+		
+		unsigned head = *_cq_head;
+		while (head != std::atomic_ref<unsigned>(*_cq_tail).load(std::memory_order_acquire))
+		{
+			const io_uring_cqe cqe = _cqes[head & *_cq_mask];
+			std::atomic_ref<unsigned>(*_cq_head).store(++head, std::memory_order_release);
+			
+			const size_t i = cqe.user_data;
+			auto& b = _buffers[i];
+			if (cqe.res < 0)
+			{
+				--_in_flight;
+				fail("write", -cqe.res);
+			}
+			if (cqe.res == 0)
+			{
+				--_in_flight;
+				fail("write", EIO);
+			}
+			
+			// Short writes continue from where they stopped
+			b.done += cqe.res;
+			if (b.done < b.size)
+			{
+				enqueue(i);
+				continue;
+			}
+			
+			b.size = 0;
+			--_in_flight;
+			_free.push_back(i);
+		}
+	}
+
+	void uring_sink::drain()
+	{
+		while (_in_flight)
+			reap(true);
+	}
+
+	void uring_sink::write(const char* data, size_t size)
+	{
+		while (size)
+		{
+			if (_current == _buffers.size())
+			{
+				reap(false);
+				while (_free.empty())
+					reap(true);
+				_current = _free.back();
+				_free.pop_back();
+			}
+			
+			auto& b = _buffers[_current];
+			const size_t n = std::min(size, _capacity - b.size);
+			std::memcpy(b.data.get() + b.size, data, n);
+			b.size += n;
+			data += n;
+			size -= n;
+			
+			if (b.size == _capacity)
+			{
+				submit(_current);
+				_current = _buffers.size();
+			}
+		}
+	}
+
+	void uring_sink::flush()
+	{
+		if (_current != _buffers.size() && _buffers[_current].size)
+		{
+			auto& b = _buffers[_current];
+			
+			if (_direct && b.size % alignment)
+			{
+				// O_DIRECT takes whole blocks only, so the tail is written through the page cache
+				drain();
+				const int flags = fcntl(_fd, F_GETFL);
+				if (flags == -1 || fcntl(_fd, F_SETFL, flags & ~O_DIRECT) == -1)
+					fail("fcntl", errno);
+				
+				fd_sink tail(_fd);
+				if (_seekable && lseek(_fd, _offset, SEEK_SET) == -1)
+					fail("lseek", errno);
+				tail.write(b.data.get(), b.size);
+				_offset += b.size;
+				_direct = false;
+				b.size = 0;
+				_free.push_back(_current);
+			}
+			else
+				submit(_current);
+			
+			_current = _buffers.size();
+		}
+		
+		drain();
+		
+		// Leave the file position after the output, as write(2) would
+		if (_seekable && lseek(_fd, _offset, SEEK_SET) == -1)
+			fail("lseek", errno);
+	}
+}//namespace tmm
@@ -0,0 +1,352 @@
+/**
+ * \file vectfit.cc
+ * \brief implementations for vectfit.h
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <vectfit.h>
+#include <bragg.h>
+#include <sampling.h>
+#include <linalg.h>
+#include <pool.h>
+#include <iostream>
+#include <algorithm>
+#include <numbers>
+
+namespace tmm
+{
+	namespace
+	{
+		constexpr size_t block = 256; ///< designs fitted in parallel between writes
+		constexpr size_t responses = 3; ///< S11, S21, S22
+		constexpr double converged = 1e-8; ///< pole relocation relative to the band at convergence
+
+		/**
+		 * \brief Zeros of d + sum_m c_m / (z - a_m) by Aberth-Ehrlich iteration
+		 * 
+		 * The zeros are those of the polynomial d prod(z - a) + sum_m c_m prod_{l != m}(z - a_l), 
+		 * whose logarithmic derivative is evaluated without forming it.
+		 * 
+		 * \param a the poles, also the starting points
+		 * \param scale length scale of the pole spread, for the stopping rule
+		 */
+		std::vector<std::complex<double>> 
+		zeros(const std::vector<std::complex<double>>& a, const std::vector<std::complex<double>>& c, 
+			std::complex<double> d, double scale)
+		{
+			const size_t n = a.size();
+			std::vector<std::complex<double>> z(n);
+			for (size_t i = 0; i < n; ++i)
+				z[i] = a[i] + std::polar(0.1 * scale, 2.0 * std::numbers::pi * i / n + 0.4);
+			
+			for (size_t it = 0; it < 200; ++it)
+			{
+				double step = 0;
+				for (size_t i = 0; i < n; ++i)
+				{
+					std::complex<double> g = d, dg = 0, h = 0;
+					for (size_t m = 0; m < n; ++m)
+					{
+						const std::complex<double> u = 1.0 / (z[i] - a[m]);
+						g += c[m] * u;
+						dg -= c[m] * u * u;
+						h += u;
+					}
+					
+					// Newton step of the polynomial, N = p/p'
+					const std::complex<double> newton = 1.0 / (h + dg / g);
+					
+					std::complex<double> repulsion = 0;
+					for (size_t j = 0; j < n; ++j)
+						if (j != i)
+							repulsion += 1.0 / (z[i] - z[j]);
+					
+					const std::complex<double> w = newton / (1.0 - newton * repulsion);
+					if (std::isfinite(w.real()) && std::isfinite(w.imag()))
+					{
+						z[i] -= w;
+						step = std::max(step, std::abs(w));
+					}
+				}
+				
+				if (step < 1e-14 * scale)
+					break;
+			}
+			
+			return z;
+		}
+
+		/**
+		 * \brief Cauchy basis 1/(s_k - a_m) followed by a constant column, K x (n + 1)
+		 */
+		std::vector<std::complex<double>> 
+		basis(const std::vector<std::complex<double>>& s, const std::vector<std::complex<double>>& a)
+		{
+			const size_t K = s.size(), n = a.size();
+			std::vector<std::complex<double>> Phi(K * (n + 1));
+			for (size_t k = 0; k < K; ++k)
+			{
+				for (size_t m = 0; m < n; ++m)
+					Phi[k * (n + 1) + m] = 1.0 / (s[k] - a[m]);
+				Phi[k * (n + 1) + n] = 1.0;
+			}
+			return Phi;
+		}
+	}
+
+	rational_model 
+	vector_fit(const std::vector<std::complex<double>>& s, 
+		const std::array<std::vector<std::complex<double>>, 3>& f, size_t order, size_t iterations)
+	{
+		const size_t K = s.size(), n = order, w = n + 1;
+		
+		double lo = INFINITY, hi = -INFINITY;
+		for (const auto& x : s)
+		{
+			lo = std::min(lo, x.imag());
+			hi = std::max(hi, x.imag());
+		}
+		const double spacing = (hi - lo) / n;
+		
+		// Starting poles spread over the band with damping of one spacing
+		rational_model model;
+		model.poles.resize(n);
+		for (size_t m = 0; m < n; ++m)
+			model.poles[m] = {-spacing, lo + (m + 0.5) * spacing};
+		
+		double norm = 0;
+		for (const auto& fj : f)
+			for (const auto& x : fj)
+				norm += std::norm(x);
+		const double weight = std::sqrt(norm) / K;
+		
+		for (; model.iterations < iterations; ++model.iterations)
+		{
+			const auto Phi = basis(s, model.poles);
+			
+			// Equations for the scaling function sigma, one block per response after 
+			// eliminating that response's residues, plus the relaxation row
+			const size_t rows = responses * w + 1;
+			std::vector<std::complex<double>> A(rows * w, 0.0), b(rows, 0.0);
+			
+			for (size_t j = 0; j < responses; ++j)
+			{
+				std::vector<std::complex<double>> B(K * 2 * w);
+				for (size_t k = 0; k < K; ++k)
+					for (size_t m = 0; m < w; ++m)
+					{
+						B[k * 2 * w + m] = Phi[k * w + m];
+						B[k * 2 * w + w + m] = -f[j][k] * Phi[k * w + m];
+					}
+				
+				householder(B, K, 2 * w);
+				for (size_t r = 0; r < w; ++r)
+					for (size_t m = 0; m < w; ++m)
+						A[(j * w + r) * w + m] = B[(w + r) * 2 * w + w + m];
+			}
+			
+			for (size_t k = 0; k < K; ++k)
+				for (size_t m = 0; m < w; ++m)
+					A[(rows - 1) * w + m] += weight * Phi[k * w + m] / static_cast<double>(K);
+			b[rows - 1] = weight;
+			
+			const auto x = least_squares(A, b, rows, w);
+			std::vector<std::complex<double>> c(x.begin(), x.begin() + n);
+			std::complex<double> d = x[n];
+			if (std::abs(d) < 1e-8)
+				d = std::abs(d) > 0 ? 1e-8 * d / std::abs(d) : 1e-8;
+			
+			// New poles are the zeros of sigma, reflected to be stable
+			auto poles = zeros(model.poles, c, d, spacing);
+			double change = 0;
+			for (size_t m = 0; m < n; ++m)
+			{
+				if (poles[m].real() > 0)
+					poles[m] = {-poles[m].real(), poles[m].imag()};
+				change = std::max(change, std::abs(poles[m] - model.poles[m]));
+			}
+			
+			std::sort(poles.begin(), poles.end(), [](const auto& p, const auto& q) { return p.imag() < q.imag(); });
+			model.poles = std::move(poles);
+			
+			if (change < converged * (hi - lo))
+			{
+				++model.iterations;
+				break;
+			}
+		}
+		
+		// Residues and constants of each response with the final poles
+		const auto Phi = basis(s, model.poles);
+		double error = 0;
+		for (size_t j = 0; j < responses; ++j)
+		{
+			const auto x = least_squares(Phi, f[j], K, w);
+			model.residues[j].assign(x.begin(), x.begin() + n);
+			model.d[j] = x[n];
+			
+			for (size_t k = 0; k < K; ++k)
+			{
+				std::complex<double> y = 0;
+				for (size_t m = 0; m < w; ++m)
+					y += Phi[k * w + m] * x[m];
+				error += std::norm(y - f[j][k]);
+			}
+		}
+		model.rms = std::sqrt(error / (responses * K));
+		
+		return model;
+	}
+
+	void 
+	enforce_passivity(rational_model& model, double lo, double hi, size_t points)
+	{
+		double largest = 0;
+		for (size_t k = 0; k < points; ++k)
+		{
+			const std::complex<double> s(0, lo + (hi - lo) * k / std::max<size_t>(points - 1, 1));
+			
+			std::array<std::complex<double>, 3> S = model.d;
+			for (size_t m = 0; m < model.poles.size(); ++m)
+			{
+				const std::complex<double> u = 1.0 / (s - model.poles[m]);
+				for (size_t j = 0; j < responses; ++j)
+					S[j] += model.residues[j][m] * u;
+			}
+			
+			// Largest eigenvalue of S^H S for S = [[S11, S21], [S21, S22]]
+			const double trace = std::norm(S[0]) + 2.0 * std::norm(S[1]) + std::norm(S[2]);
+			const double det = std::norm(S[0] * S[2] - S[1] * S[1]);
+			const double sigma = 0.5 * (trace + std::sqrt(std::max(trace * trace - 4.0 * det, 0.0)));
+			largest = std::max(largest, sigma);
+		}
+		
+		model.scale = std::max(1.0, std::sqrt(largest));
+		if (model.scale > 1.0)
+		{
+			for (size_t j = 0; j < responses; ++j)
+			{
+				for (auto& r : model.residues[j])
+					r /= model.scale;
+				model.d[j] /= model.scale;
+			}
+		}
+	}
+
+	int 
+	vectfit(const ctl& ctx)
+	{
+		const auto points = designs(ctx);
+		const size_t K = ctx.wavelengths.size();
+		
+		// Baseband frequency s = 2 pi i (nu - nu0) in rad/ps around the window centre
+		const auto [lmin, lmax] = std::minmax_element(ctx.wavelengths.begin(), ctx.wavelengths.end());
+		const double nu0 = 0.5 * (c_um_ps / *lmin + c_um_ps / *lmax);
+		std::vector<std::complex<double>> s(K);
+		for (size_t k = 0; k < K; ++k)
+			s[k] = {0.0, 2.0 * std::numbers::pi * (c_um_ps / ctx.wavelengths[k] - nu0)};
+		const double lo = 2.0 * std::numbers::pi * (c_um_ps / *lmax - nu0);
+		const double hi = 2.0 * std::numbers::pi * (c_um_ps / *lmin - nu0);
+		
+		std::cerr << "[INFO] vectfit: S(s) = d + sum r/(s - p), s = 2 pi i (nu - " << nu0 
+			<< " THz) in rad/ps, nu = " << c_um_ps << "/wavelength" << std::endl;
+		
+		bool sweep_width1 = !ctx.width1.empty();
+		bool sweep_width2 = !ctx.width2.empty();
+		
+		printf("period,duty_cycle,N");
+		if (sweep_width1) printf(",w1");
+		if (sweep_width2) printf(",w2");
+		printf(",term,pole_re,pole_im,s11_re,s11_im,s21_re,s21_im,s22_re,s22_im,rms,passivity_scale\n");
+		
+		std::vector<rational_model> models(block);
+		double worst = 0;
+		
+		for (size_t begin = 0; begin < points.size(); begin += block)
+		{
+			const size_t end = std::min(begin + block, points.size());
+			
+			parallel_for(end - begin, [&](size_t j, size_t)
+			{
+				const auto& d = points[begin + j];
+				Bragg grating(d.period, d.duty_cycle, d.N);
+				
+				std::array<std::vector<std::complex<double>>, 3> f;
+				for (auto& x : f)
+					x.resize(K);
+				
+				for (size_t k = 0; k < K; ++k)
+				{
+					const double wavelength = ctx.wavelengths[k];
+					const auto S = grating.scattering_parameters(wavelength, 
+						(*ctx.n1)(wavelength, d.w1, k), 
+						(*ctx.n2)(wavelength, d.w2, k), 
+						(*ctx.loss)(wavelength, 0.0, k));
+					f[0][k] = S.S11;
+					f[1][k] = S.S21;
+					f[2][k] = S.S22;
+				}
+				
+				models[j] = vector_fit(s, f, ctx.poles, ctx.iterations);
+				enforce_passivity(models[j], lo, hi, 4 * K);
+			}, ctx.threads);
+			
+			for (size_t j = 0; j < end - begin; ++j)
+			{
+				const auto& d = points[begin + j];
+				const auto& model = models[j];
+				worst = std::max(worst, model.rms);
+				
+				auto prefix = [&]()
+				{
+					printf("%.6g,%.6g,%.6g", d.period, d.duty_cycle, d.N);
+					if (sweep_width1) printf(",%.6g", d.w1);
+					if (sweep_width2) printf(",%.6g", d.w2);
+				};
+				
+				for (size_t m = 0; m < model.poles.size(); ++m)
+				{
+					prefix();
+					printf(",%zu,%.10g,%.10g", m, model.poles[m].real(), model.poles[m].imag());
+					for (size_t r = 0; r < responses; ++r)
+						printf(",%.10g,%.10g", model.residues[r][m].real(), model.residues[r][m].imag());
+					printf(",%.6g,%.6g\n", model.rms, model.scale);
+				}
+				
+				prefix();
+				printf(",d,nan,nan");
+				for (size_t r = 0; r < responses; ++r)
+					printf(",%.10g,%.10g", model.d[r].real(), model.d[r].imag());
+				printf(",%.6g,%.6g\n", model.rms, model.scale);
+			}
+		}
+		
+		std::cerr << "[INFO] vectfit: " << points.size() << " models of " << ctx.poles 
+			<< " poles, worst rms " << worst << std::endl;
+		
+		return 0;
+	}
+}//namespace tmm
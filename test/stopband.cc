@@ -0,0 +1,122 @@
+/**
+ * \file stopband.cc
+ * \brief regression checks of the scattering coefficients and the batch kernel
+ * \author cpapakonstantinou
+ * \date 2026
+ * 
+ */
+
+// Copyright (c) 2026  Constantine Papakonstantinou
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <bragg.h>
+#include <batch.h>
+#include <iostream>
+
+using namespace tmm;
+
+namespace
+{
+	int failures = 0;
+
+	void check(bool ok, const char* what)
+	{
+		if (!ok)
+		{
+			std::cerr << "[FAIL] " << what << std::endl;
+			++failures;
+		}
+	}
+
+	/**
+	 * \brief Deep stopband of a long grating, where |M[0,0]|^2 overflows a double
+	 * 
+	 * A quarter-wave stack of 3.5/1.5 at 1.55 with 1000 periods has |M[0,0]| near 1e300.
+	 * R must be 1 and the phases those of the ratios, not NaN from inf/inf.
+	 */
+	void stopband()
+	{
+		Bragg bragg(0.25, 0.5, 1000);
+		auto [R, T, r, t] = bragg.scattering_coefficients(1.55, 3.5, 1.5, 0);
+		
+		check(std::abs(R - 1) < 1e-12, "stopband: R = 1");
+		check(T >= 0 && T < 1e-300, "stopband: T = 0");
+		check(std::abs(r + 2.4333) < 1e-4, "stopband: phase_r");
+		check(std::isfinite(t), "stopband: phase_t finite");
+	}
+
+	/**
+	 * \brief Batch kernel against the normalized scalar power, N up to 10000
+	 * 
+	 * Lanes mix N, wavelengths inside and outside the stopband, and loss, so that 
+	 * each lane rescales at its own steps.
+	 */
+	void batch()
+	{
+		design_batch<> batch;
+		const uint64_t N[] = {1, 10, 100, 1000, 3000, 10000, 1000, 5};
+		const double wavelength[] = {1.55, 1.55, 1.55, 1.55, 1.55, 1.55, 1.6, 1.48};
+		const double loss[] = {0, 0, 0, 0, 1e-3, 0, 0, 1e-2};
+		for (size_t l = 0; l < batch_lanes; ++l)
+		{
+			batch.wavelength[l] = wavelength[l];
+			batch.period[l] = 0.25;
+			batch.duty_cycle[l] = 0.5;
+			batch.N[l] = N[l];
+			batch.n1[l] = 3.5;
+			batch.n2[l] = 1.5;
+			batch.loss[l] = loss[l];
+		}
+		batch.count = batch_lanes;
+		
+		batch_result<> result;
+		batch_coefficients(batch, true, result);
+		
+		auto Tp = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		auto M = damm::aligned_alloc_2D<std::complex<double>, 64>(2, 2);
+		for (size_t l = 0; l < batch_lanes; ++l)
+		{
+			Bragg bragg(0.25, 0.5, N[l]);
+			bragg.transfer_matrix(Tp.get(), wavelength[l], 3.5, 1.5, loss[l]);
+			const auto S = scattering_parameters(M.get(), scaled_power(Tp.get(), M.get(), N[l]));
+			
+			const double R = std::norm(S.S11), T = std::norm(S.S21);
+			const auto phase = [](double a, double b){ return std::abs(std::remainder(a - b, 2 * pi)); };
+			
+			check(std::isfinite(result.R[l]) && std::abs(result.R[l] - R) <= 1e-9 * std::max(R, 1e-300), "batch: R");
+			check(std::abs(result.T[l] - T) <= 1e-9 * std::max(T, 1e-300), "batch: T");
+			check(phase(result.r[l], std::arg(S.S11)) < 1e-6, "batch: phase_r");
+			// S21 underflows to 0 deep in the stopband, its phase is that of 1 / M[0,0]
+			check(phase(result.t[l], std::arg(1.0 / M[0][0])) < 1e-6, "batch: phase_t");
+		}
+	}
+}
+
+int main()
+{
+	stopband();
+	batch();
+	
+	if (failures)
+		return 1;
+	std::cout << "[INFO] test: passed" << std::endl;
+	return 0;
+}